@@ -22,6 +22,8 @@
 #   CMAKE_REQUIRED_INCLUDES = list of include directories
 #   CMAKE_REQUIRED_LIBRARIES = list of libraries to link
 #   CMAKE_REQUIRED_QUIET = execute quietly without messages
+#   CMAKE_REQUIRED_DEFER = queue the check with try_compile(DEFER) and
+#                          set <variable> at the next try_compile_wait()
 
 #=============================================================================
 # Copyright 2002-2011 Kitware, Inc.
@@ -66,6 +68,12 @@ macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
     else()
       message(FATAL_ERROR "CHECK_FUNCTION_EXISTS needs either C or CXX language enabled")
     endif()
+    if(CMAKE_REQUIRED_DEFER)
+      set(CHECK_FUNCTION_EXISTS_DEFER
+        DEFER CALLBACK _CHECK_FUNCTION_EXISTS_RESULT "${FUNCTION}" "${VARIABLE}")
+    else()
+      set(CHECK_FUNCTION_EXISTS_DEFER)
+    endif()
 
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
@@ -74,25 +82,32 @@ macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
       ${CHECK_FUNCTION_EXISTS_ADD_LIBRARIES}
       CMAKE_FLAGS -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_FUNCTION_DEFINITIONS}
       "${CHECK_FUNCTION_EXISTS_ADD_INCLUDES}"
-      OUTPUT_VARIABLE OUTPUT)
+      OUTPUT_VARIABLE OUTPUT
+      ${CHECK_FUNCTION_EXISTS_DEFER})
     unset(_cfe_source)
 
-    if(${VARIABLE})
-      set(${VARIABLE} 1 CACHE INTERNAL "Have function ${FUNCTION}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(STATUS "Looking for ${FUNCTION} - found")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the function ${FUNCTION} exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(STATUS "Looking for ${FUNCTION} - not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have function ${FUNCTION}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the function ${FUNCTION} exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
+    if(NOT CMAKE_REQUIRED_DEFER)
+      _CHECK_FUNCTION_EXISTS_RESULT("${FUNCTION}" "${VARIABLE}")
+    endif()
+  endif()
+endmacro()
+
+macro(_CHECK_FUNCTION_EXISTS_RESULT FUNCTION VARIABLE)
+  if(${VARIABLE})
+    set(${VARIABLE} 1 CACHE INTERNAL "Have function ${FUNCTION}")
+    if(NOT CMAKE_REQUIRED_QUIET)
+      message(STATUS "Looking for ${FUNCTION} - found")
+    endif()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the function ${FUNCTION} exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT CMAKE_REQUIRED_QUIET)
+      message(STATUS "Looking for ${FUNCTION} - not found")
     endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have function ${FUNCTION}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the function ${FUNCTION} exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
   endif()
 endmacro()
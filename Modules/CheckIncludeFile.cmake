@@ -26,6 +26,10 @@
 #   list of include directories
 # ``CMAKE_REQUIRED_QUIET``
 #   execute quietly without messages
+# ``CMAKE_REQUIRED_DEFER``
+#   queue the check with the ``DEFER`` option of :command:`try_compile`.
+#   The result variable is set once :command:`try_compile_wait` is called
+#   or the end of the current directory is reached.
 #
 # See the :module:`CheckIncludeFiles` module to check for multiple headers
 # at once.  See the :module:`CheckIncludeFileCXX` module to check for headers
@@ -62,6 +66,12 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       set(CMAKE_C_FLAGS_SAVE ${CMAKE_C_FLAGS})
       set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${ARGV2}")
     endif()
+    if(CMAKE_REQUIRED_DEFER)
+      set(CHECK_INCLUDE_FILE_DEFER
+        DEFER CALLBACK _CHECK_INCLUDE_FILE_RESULT "${INCLUDE}" "${VARIABLE}")
+    else()
+      set(CHECK_INCLUDE_FILE_DEFER)
+    endif()
 
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
@@ -70,30 +80,37 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       CMAKE_FLAGS
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_INCLUDE_FILE_FLAGS}
       "${CHECK_INCLUDE_FILE_C_INCLUDE_DIRS}"
-      OUTPUT_VARIABLE OUTPUT)
+      OUTPUT_VARIABLE OUTPUT
+      ${CHECK_INCLUDE_FILE_DEFER})
 
     if(${ARGC} EQUAL 3)
       set(CMAKE_C_FLAGS ${CMAKE_C_FLAGS_SAVE})
     endif()
 
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(STATUS "Looking for ${INCLUDE} - found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the include file ${INCLUDE} "
-        "exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(STATUS "Looking for ${INCLUDE} - not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the include file ${INCLUDE} "
-        "exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
+    if(NOT CMAKE_REQUIRED_DEFER)
+      _CHECK_INCLUDE_FILE_RESULT("${INCLUDE}" "${VARIABLE}")
+    endif()
+  endif()
+endmacro()
+
+macro(_CHECK_INCLUDE_FILE_RESULT INCLUDE VARIABLE)
+  if(${VARIABLE})
+    if(NOT CMAKE_REQUIRED_QUIET)
+      message(STATUS "Looking for ${INCLUDE} - found")
+    endif()
+    set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the include file ${INCLUDE} "
+      "exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT CMAKE_REQUIRED_QUIET)
+      message(STATUS "Looking for ${INCLUDE} - not found")
     endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have include ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the include file ${INCLUDE} "
+      "exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
   endif()
 endmacro()
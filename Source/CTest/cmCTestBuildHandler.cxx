@@ -34,6 +34,7 @@
 #include <float.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 static const char* cmCTestErrorMatches[] = {
@@ -199,14 +200,10 @@ void cmCTestBuildHandler::Initialize()
   this->ReallyCustomWarningExceptions.clear();
   this->ErrorWarningFileLineRegex.clear();
 
-  this->ErrorMatchRegex.clear();
-  this->ErrorExceptionRegex.clear();
-  this->WarningMatchRegex.clear();
-  this->WarningExceptionRegex.clear();
+  this->LineRegex.Clear();
   this->BuildProcessingQueue.clear();
   this->BuildProcessingErrorQueue.clear();
   this->BuildOutputLogSize = 0;
-  this->CurrentProcessingLine.clear();
 
   this->SimplifySourceDir = "";
   this->SimplifyBuildDir = "";
@@ -371,24 +368,24 @@ int cmCTestBuildHandler::ProcessHandler()
   // Pre-compile regular expressions objects for all regular expressions
   std::vector<std::string>::iterator it;
 
-#define cmCTestBuildHandlerPopulateRegexVector(strings, regexes)              \
-  regexes.clear();                                                            \
+  this->LineRegex.Clear();
+#define cmCTestBuildHandlerPopulateRegexGroup(strings, group)                 \
   cmCTestOptionalLog(this->CTest, DEBUG,                                      \
-                     this << "Add " #regexes << std::endl, this->Quiet);      \
+                     this << "Add " #group << std::endl, this->Quiet);        \
   for (it = strings.begin(); it != strings.end(); ++it) {                     \
     cmCTestOptionalLog(this->CTest, DEBUG,                                    \
                        "Add " #strings ": " << *it << std::endl,              \
                        this->Quiet);                                          \
-    regexes.push_back(it->c_str());                                           \
+    this->LineRegex.Add(group, *it);                                          \
   }
-  cmCTestBuildHandlerPopulateRegexVector(this->CustomErrorMatches,
-                                         this->ErrorMatchRegex);
-  cmCTestBuildHandlerPopulateRegexVector(this->CustomErrorExceptions,
-                                         this->ErrorExceptionRegex);
-  cmCTestBuildHandlerPopulateRegexVector(this->CustomWarningMatches,
-                                         this->WarningMatchRegex);
-  cmCTestBuildHandlerPopulateRegexVector(this->CustomWarningExceptions,
-                                         this->WarningExceptionRegex);
+  cmCTestBuildHandlerPopulateRegexGroup(this->CustomErrorMatches,
+                                        ErrorMatchGroup);
+  cmCTestBuildHandlerPopulateRegexGroup(this->CustomErrorExceptions,
+                                        ErrorExceptionGroup);
+  cmCTestBuildHandlerPopulateRegexGroup(this->CustomWarningMatches,
+                                        WarningMatchGroup);
+  cmCTestBuildHandlerPopulateRegexGroup(this->CustomWarningExceptions,
+                                        WarningExceptionGroup);
 
   // Determine source and binary tree substitutions to simplify the output.
   this->SimplifySourceDir = "";
@@ -945,20 +942,17 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
                                         t_BuildProcessingQueueType* queue)
 {
   const std::string::size_type tick_line_len = 50;
-  const char* ptr;
-  for (ptr = data; ptr < data + length; ptr++) {
-    queue->push_back(*ptr);
-  }
+  queue->insert(queue->end(), data, data + length);
   this->BuildOutputLogSize += length;
 
   // until there are any lines left in the buffer
+  size_t lineBegin = 0;
   while (1) {
     // Find the end of line
-    t_BuildProcessingQueueType::iterator it;
-    for (it = queue->begin(); it != queue->end(); ++it) {
-      if (*it == '\n') {
-        break;
-      }
+    char* lineEnd = 0;
+    if (lineBegin < queue->size()) {
+      lineEnd = static_cast<char*>(
+        memchr(&(*queue)[lineBegin], '\n', queue->size() - lineBegin));
     }
 
     // Once certain number of errors or warnings reached, ignore future errors
@@ -971,20 +965,15 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
     }
 
     // If the end of line was found
-    if (it != queue->end()) {
-      // Create a contiguous array for the line
-      this->CurrentProcessingLine.clear();
-      this->CurrentProcessingLine.insert(this->CurrentProcessingLine.end(),
-                                         queue->begin(), it);
-      this->CurrentProcessingLine.push_back(0);
-      const char* line = &*this->CurrentProcessingLine.begin();
+    if (lineEnd) {
+      // Terminate the line in place
+      *lineEnd = 0;
+      const char* line = &(*queue)[lineBegin];
+      lineBegin += lineEnd - line + 1;
 
       // Process the line
       int lineType = this->ProcessSingleLine(line);
 
-      // Erase the line from the queue
-      queue->erase(queue->begin(), it + 1);
-
       // Depending on the line type, produce error or warning, or nothing
       cmCTestBuildErrorWarning errorwarning;
       bool found = false;
@@ -1048,6 +1037,9 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
     }
   }
 
+  // Keep the incomplete last line for the next chunk
+  queue->erase(queue->begin(), queue->begin() + lineBegin);
+
   // Now that the buffer is processed, display missing ticks
   int tickDisplayed = false;
   while (this->BuildOutputLogSize > (tick * tick_len)) {
@@ -1085,76 +1077,58 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
   cmCTestOptionalLog(this->CTest, DEBUG, "Line: [" << data << "]" << std::endl,
                      this->Quiet);
 
-  std::vector<cmsys::RegularExpression>::iterator it;
-
   int warningLine = 0;
   int errorLine = 0;
 
-  // Check for regular expressions
+  // Check for regular expressions.  One scan of the line finds the
+  // expressions that can possibly match.
+  if (!this->ErrorQuotaReached || !this->WarningQuotaReached) {
+    this->LineRegex.Scan(data);
+  }
 
   if (!this->ErrorQuotaReached) {
     // Errors
-    int wrxCnt = 0;
-    for (it = this->ErrorMatchRegex.begin(); it != this->ErrorMatchRegex.end();
-         ++it) {
-      if (it->find(data)) {
-        errorLine = 1;
-        cmCTestOptionalLog(this->CTest, DEBUG,
-                           "  Error Line: " << data << " (matches: "
-                                            << this->CustomErrorMatches[wrxCnt]
-                                            << ")" << std::endl,
-                           this->Quiet);
-        break;
-      }
-      wrxCnt++;
+    int wrxCnt = this->LineRegex.Find(ErrorMatchGroup, data);
+    if (wrxCnt >= 0) {
+      errorLine = 1;
+      cmCTestOptionalLog(this->CTest, DEBUG,
+                         "  Error Line: " << data << " (matches: "
+                                          << this->CustomErrorMatches[wrxCnt]
+                                          << ")" << std::endl,
+                         this->Quiet);
     }
     // Error exceptions
-    wrxCnt = 0;
-    for (it = this->ErrorExceptionRegex.begin();
-         it != this->ErrorExceptionRegex.end(); ++it) {
-      if (it->find(data)) {
-        errorLine = 0;
-        cmCTestOptionalLog(this->CTest, DEBUG, "  Not an error Line: "
-                             << data << " (matches: "
-                             << this->CustomErrorExceptions[wrxCnt] << ")"
-                             << std::endl,
-                           this->Quiet);
-        break;
-      }
-      wrxCnt++;
+    wrxCnt = this->LineRegex.Find(ErrorExceptionGroup, data);
+    if (wrxCnt >= 0) {
+      errorLine = 0;
+      cmCTestOptionalLog(this->CTest, DEBUG, "  Not an error Line: "
+                           << data << " (matches: "
+                           << this->CustomErrorExceptions[wrxCnt] << ")"
+                           << std::endl,
+                         this->Quiet);
     }
   }
   if (!this->WarningQuotaReached) {
     // Warnings
-    int wrxCnt = 0;
-    for (it = this->WarningMatchRegex.begin();
-         it != this->WarningMatchRegex.end(); ++it) {
-      if (it->find(data)) {
-        warningLine = 1;
-        cmCTestOptionalLog(this->CTest, DEBUG, "  Warning Line: "
-                             << data << " (matches: "
-                             << this->CustomWarningMatches[wrxCnt] << ")"
-                             << std::endl,
-                           this->Quiet);
-        break;
-      }
-      wrxCnt++;
+    int wrxCnt = this->LineRegex.Find(WarningMatchGroup, data);
+    if (wrxCnt >= 0) {
+      warningLine = 1;
+      cmCTestOptionalLog(this->CTest, DEBUG, "  Warning Line: "
+                           << data << " (matches: "
+                           << this->CustomWarningMatches[wrxCnt] << ")"
+                           << std::endl,
+                         this->Quiet);
     }
 
-    wrxCnt = 0;
     // Warning exceptions
-    for (it = this->WarningExceptionRegex.begin();
-         it != this->WarningExceptionRegex.end(); ++it) {
-      if (it->find(data)) {
-        warningLine = 0;
-        cmCTestOptionalLog(this->CTest, DEBUG, "  Not a warning Line: "
-                             << data << " (matches: "
-                             << this->CustomWarningExceptions[wrxCnt] << ")"
-                             << std::endl,
-                           this->Quiet);
-        break;
-      }
-      wrxCnt++;
+    wrxCnt = this->LineRegex.Find(WarningExceptionGroup, data);
+    if (wrxCnt >= 0) {
+      warningLine = 0;
+      cmCTestOptionalLog(this->CTest, DEBUG, "  Not a warning Line: "
+                           << data << " (matches: "
+                           << this->CustomWarningExceptions[wrxCnt] << ")"
+                           << std::endl,
+                         this->Quiet);
     }
   }
   if (errorLine) {
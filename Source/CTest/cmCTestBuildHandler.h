@@ -15,6 +15,7 @@
 
 #include "cmCTestGenericHandler.h"
 
+#include "cmCTestRegexSet.h"
 #include "cmListFileCache.h"
 
 #include <cmsys/RegularExpression.hxx>
@@ -107,12 +108,17 @@ private:
   std::vector<std::string> ReallyCustomWarningExceptions;
   std::vector<cmCTestCompileErrorWarningRex> ErrorWarningFileLineRegex;
 
-  std::vector<cmsys::RegularExpression> ErrorMatchRegex;
-  std::vector<cmsys::RegularExpression> ErrorExceptionRegex;
-  std::vector<cmsys::RegularExpression> WarningMatchRegex;
-  std::vector<cmsys::RegularExpression> WarningExceptionRegex;
+  // Groups of expressions in LineRegex.
+  enum
+  {
+    ErrorMatchGroup,
+    ErrorExceptionGroup,
+    WarningMatchGroup,
+    WarningExceptionGroup
+  };
+  cmCTestRegexSet LineRegex;
 
-  typedef std::deque<char> t_BuildProcessingQueueType;
+  typedef std::vector<char> t_BuildProcessingQueueType;
 
   void ProcessBuffer(const char* data, int length, size_t& tick,
                      size_t tick_len, std::ostream& ofs,
@@ -122,7 +128,6 @@ private:
   t_BuildProcessingQueueType BuildProcessingQueue;
   t_BuildProcessingQueueType BuildProcessingErrorQueue;
   size_t BuildOutputLogSize;
-  std::vector<char> CurrentProcessingLine;
 
   std::string SimplifySourceDir;
   std::string SimplifyBuildDir;
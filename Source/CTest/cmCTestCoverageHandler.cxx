@@ -107,6 +107,21 @@ public:
     return this->PipeState;
   }
   int GetProcessState() { return this->PipeState; }
+  int GetState() { return cmsysProcess_GetState(this->Process); }
+  int GetExitValue() { return cmsysProcess_GetExitValue(this->Process); }
+  const char* GetErrorString()
+  {
+    if (this->GetState() == cmsysProcess_State_Exception) {
+      return cmsysProcess_GetExceptionString(this->Process);
+    }
+    if (this->GetState() == cmsysProcess_State_Error) {
+      return cmsysProcess_GetErrorString(this->Process);
+    }
+    if (this->GetState() == cmsysProcess_State_Expired) {
+      return "Process terminated due to timeout";
+    }
+    return 0;
+  }
 private:
   int PipeState;
   cmsysProcess* Process;
@@ -115,6 +130,34 @@ private:
   double TimeOut;
 };
 
+// One invocation of gcov on a group of coverage data files that share an
+// object directory.  Output is redirected to files in the private working
+// directory of the invocation so that several may run at once.
+struct cmCTestCoverageHandlerGCovJob
+{
+  cmCTestCoverageHandlerGCovJob()
+    : Process(0)
+  {
+  }
+  std::string Directory;
+  std::vector<std::string> Files;
+  std::string WorkDir;
+  std::string Command;
+  cmCTestRunProcess* Process;
+};
+
+static std::string cmCTestCoverageHandlerReadFile(std::string const& fname)
+{
+  std::string content;
+  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  char buffer[4096];
+  while (fin) {
+    fin.read(buffer, sizeof(buffer));
+    content.append(buffer, static_cast<size_t>(fin.gcount()));
+  }
+  return content;
+}
+
 cmCTestCoverageHandler::cmCTestCoverageHandler()
 {
 }
@@ -997,37 +1040,118 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   cmCTestCoverageHandlerLocale locale_C;
   static_cast<void>(locale_C);
 
+  // gcov accepts several data files sharing one object directory.  Without
+  // long file names the .gcov outputs for sources included by more than
+  // one of them would overwrite each other, so batch them only with -l.
+  bool longFileNames = false;
+  std::vector<std::string> gcovFlags =
+    cmSystemTools::ParseArguments(gcovExtraFlags.c_str());
+  for (std::vector<std::string>::const_iterator fi = gcovFlags.begin();
+       fi != gcovFlags.end(); ++fi) {
+    if (*fi == "--long-file-names" ||
+        (fi->size() > 1 && (*fi)[0] == '-' && (*fi)[1] != '-' &&
+         fi->find('l') != std::string::npos)) {
+      longFileNames = true;
+    }
+  }
+  size_t const maxBatchSize = longFileNames ? 32 : 1;
+
   // files is a list of *.da and *.gcda files with coverage data in them.
   // These are binary files that you give as input to gcov so that it will
   // give us text output we can analyze to summarize coverage.
   //
+  std::vector<cmCTestCoverageHandlerGCovJob> jobs;
+  std::map<std::string, size_t> openJobs;
   for (it = files.begin(); it != files.end(); ++it) {
-    cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
-                       this->Quiet);
-
-    // Call gcov to get coverage data for this *.gcda file:
-    //
     std::string fileDir = cmSystemTools::GetFilenamePath(*it);
-    std::string command = "\"" + gcovCommand + "\" " + gcovExtraFlags + " " +
-      "-o \"" + fileDir + "\" " + "\"" + *it + "\"";
+    std::map<std::string, size_t>::iterator oj = openJobs.find(fileDir);
+    if (oj == openJobs.end() ||
+        jobs[oj->second].Files.size() >= maxBatchSize) {
+      openJobs[fileDir] = jobs.size();
+      jobs.push_back(cmCTestCoverageHandlerGCovJob());
+      jobs.back().Directory = fileDir;
+      jobs.back().Files.push_back(*it);
+    } else {
+      jobs[oj->second].Files.push_back(*it);
+    }
+  }
+
+  // Keep up to the parallel level of gcov invocations running ahead of
+  // the one whose output is being parsed.  Each concurrent invocation
+  // needs its own working directory for the .gcov files it writes.
+  size_t parallelLevel = 1;
+  if (this->CTest->GetParallelLevel() > 1) {
+    parallelLevel = static_cast<size_t>(this->CTest->GetParallelLevel());
+  }
+  for (size_t ji = 0; ji < jobs.size(); ++ji) {
+    if (parallelLevel == 1) {
+      jobs[ji].WorkDir = tempDir;
+    } else {
+      std::ostringstream workDir;
+      workDir << tempDir << "/gcov-" << ji % parallelLevel;
+      jobs[ji].WorkDir = workDir.str();
+      cmSystemTools::MakeDirectory(jobs[ji].WorkDir.c_str());
+    }
+  }
 
+  size_t started = 0;
+  for (size_t ji = 0; ji < jobs.size(); ++ji) {
+    for (; started < jobs.size() && started < ji + parallelLevel; ++started) {
+      cmCTestCoverageHandlerGCovJob& next = jobs[started];
+
+      // Call gcov to get coverage data for these *.gcda files:
+      //
+      next.Command = "\"" + gcovCommand + "\" " + gcovExtraFlags + " " +
+        "-o \"" + next.Directory + "\"";
+      for (std::vector<std::string>::const_iterator fi = next.Files.begin();
+           fi != next.Files.end(); ++fi) {
+        next.Command += " \"" + *fi + "\"";
+      }
+      std::vector<std::string> args =
+        cmSystemTools::ParseArguments(next.Command.c_str());
+      next.Process = new cmCTestRunProcess;
+      next.Process->SetCommand(args[0].c_str());
+      for (std::vector<std::string>::const_iterator ai = args.begin() + 1;
+           ai != args.end(); ++ai) {
+        next.Process->AddArgument(ai->c_str());
+      }
+      next.Process->SetWorkingDirectory(next.WorkDir.c_str());
+      next.Process->SetStdoutFile((next.WorkDir + "/gcov.stdout").c_str());
+      next.Process->SetStderrFile((next.WorkDir + "/gcov.stderr").c_str());
+      next.Process->StartProcess();
+    }
+
+    cmCTestCoverageHandlerGCovJob& job = jobs[ji];
+    for (size_t fi = 0; fi < job.Files.size(); ++fi) {
+      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
+                         this->Quiet);
+    }
     cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-                       command << std::endl, this->Quiet);
+                       job.Command << std::endl, this->Quiet);
 
-    std::string output = "";
-    std::string errors = "";
+    job.Process->WaitForExit();
+    std::string output =
+      cmCTestCoverageHandlerReadFile(job.WorkDir + "/gcov.stdout");
+    std::string errors =
+      cmCTestCoverageHandlerReadFile(job.WorkDir + "/gcov.stderr");
     int retVal = 0;
-    *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
-    *cont->OFS << "  Command: " << command << std::endl;
-    int res =
-      this->CTest->RunCommand(command.c_str(), &output, &errors, &retVal,
-                              tempDir.c_str(), 0 /*this->TimeOut*/);
+    bool res = job.Process->GetState() == cmsysProcess_State_Exited;
+    if (res) {
+      retVal = job.Process->GetExitValue();
+    } else if (const char* error_str = job.Process->GetErrorString()) {
+      errors += error_str;
+    }
+    delete job.Process;
+    job.Process = 0;
 
+    *cont->OFS << "* Run coverage for: " << job.Directory << std::endl;
+    *cont->OFS << "  Command: " << job.Command << std::endl;
     *cont->OFS << "  Output: " << output << std::endl;
     *cont->OFS << "  Errors: " << errors << std::endl;
     if (!res) {
       cmCTestLog(this->CTest, ERROR_MESSAGE,
-                 "Problem running coverage on file: " << *it << std::endl);
+                 "Problem running coverage on file: " << job.Files[0]
+                                                      << std::endl);
       cmCTestLog(this->CTest, ERROR_MESSAGE,
                  "Command produced error: " << errors << std::endl);
       cont->Error++;
@@ -1035,7 +1159,8 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
     }
     if (retVal != 0) {
       cmCTestLog(this->CTest, ERROR_MESSAGE, "Coverage command returned: "
-                   << retVal << " while processing: " << *it << std::endl);
+                   << retVal << " while processing: " << job.Files[0]
+                   << std::endl);
       cmCTestLog(this->CTest, ERROR_MESSAGE,
                  "Command produced error: " << cont->Error << std::endl);
     }
@@ -1190,7 +1315,11 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
                            "   in gcovFile: " << gcovFile << std::endl,
                            this->Quiet);
 
-        cmsys::ifstream ifile(gcovFile.c_str());
+        std::string gcovPath = gcovFile;
+        if (!cmSystemTools::FileIsFullPath(gcovPath.c_str())) {
+          gcovPath = job.WorkDir + "/" + gcovFile;
+        }
+        cmsys::ifstream ifile(gcovPath.c_str());
         if (!ifile) {
           cmCTestLog(this->CTest, ERROR_MESSAGE,
                      "Cannot open file: " << gcovFile << std::endl);
@@ -1291,14 +1420,16 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
       }
     }
 
-    file_count++;
+    for (size_t fi = 0; fi < job.Files.size(); ++fi) {
+      file_count++;
 
-    if (file_count % 50 == 0) {
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
-                         " processed: " << file_count << " out of "
-                                        << files.size() << std::endl,
-                         this->Quiet);
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+      if (file_count % 50 == 0) {
+        cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
+                           " processed: " << file_count << " out of "
+                                          << files.size() << std::endl,
+                           this->Quiet);
+        cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+      }
     }
   }
 
@@ -24,9 +24,11 @@
 #include <cmsys/Process.h>
 #include <cmsys/RegularExpression.hxx>
 
+#include <ctype.h>
 #include <float.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 struct CatToErrorType
 {
@@ -119,6 +121,145 @@ public:
   std::string Log;
 };
 
+// Valgrind text output defects, in the order they are tried.
+static CatToErrorType cmCTestMemCheckValgrindText[] = {
+  { "== .*Invalid free\\(\\) / delete / delete\\[\\]",
+    cmCTestMemCheckHandler::FIM },
+  { "== .*Mismatched free\\(\\) / delete / delete \\[\\]",
+    cmCTestMemCheckHandler::FMM },
+  { "== .*[0-9,]+ bytes in [0-9,]+ blocks are definitely lost"
+    " in loss record [0-9,]+ of [0-9,]+",
+    cmCTestMemCheckHandler::MLK },
+  { "== .*[0-9,]+ \\([0-9,]+ direct, [0-9,]+ indirect\\)"
+    " bytes in [0-9,]+ blocks are definitely lost"
+    " in loss record [0-9,]+ of [0-9,]+",
+    cmCTestMemCheckHandler::MLK },
+  { "== .*Syscall param .* (contains|points to) unaddressable byte\\(s\\)",
+    cmCTestMemCheckHandler::PAR },
+  { "== .*[0-9,]+ bytes in [0-9,]+ blocks are possibly lost in"
+    " loss record [0-9,]+ of [0-9,]+",
+    cmCTestMemCheckHandler::MPK },
+  { "== .*[0-9,]+ bytes in [0-9,]+ blocks are still reachable"
+    " in loss record [0-9,]+ of [0-9,]+",
+    cmCTestMemCheckHandler::MPK },
+  { "== .*Conditional jump or move depends on uninitialised value\\(s\\)",
+    cmCTestMemCheckHandler::UMC },
+  { "== .*Use of uninitialised value of size [0-9,]+",
+    cmCTestMemCheckHandler::UMR },
+  { "== .*Invalid read of size [0-9,]+", cmCTestMemCheckHandler::UMR },
+  { "== .*Jump to the invalid address ", cmCTestMemCheckHandler::UMR },
+  { "== .*Syscall param .* contains "
+    "uninitialised or unaddressable byte\\(s\\)",
+    cmCTestMemCheckHandler::UMR },
+  { "== .*Syscall param .* uninitialised", cmCTestMemCheckHandler::UMR },
+  { "== .*Invalid write of size [0-9,]+", cmCTestMemCheckHandler::IPW },
+  { "== .*pthread_mutex_unlock: mutex is "
+    "locked by a different thread",
+    cmCTestMemCheckHandler::ABR },
+  { 0, 0 }
+};
+
+// Valgrind XML output error kinds.  Other kinds are classified by their
+// description like the text output.
+static CatToErrorType cmCTestMemCheckValgrindKinds[] = {
+  { "InvalidFree", cmCTestMemCheckHandler::FIM },
+  { "MismatchedFree", cmCTestMemCheckHandler::FMM },
+  { "InvalidRead", cmCTestMemCheckHandler::UMR },
+  { "InvalidWrite", cmCTestMemCheckHandler::IPW },
+  { "InvalidJump", cmCTestMemCheckHandler::UMR },
+  { "UninitCondition", cmCTestMemCheckHandler::UMC },
+  { "UninitValue", cmCTestMemCheckHandler::UMR },
+  { "Leak_DefinitelyLost", cmCTestMemCheckHandler::MLK },
+  { "Leak_PossiblyLost", cmCTestMemCheckHandler::MPK },
+  { "Leak_StillReachable", cmCTestMemCheckHandler::MPK },
+  { 0, 0 }
+};
+
+// parse the xml output of valgrind --xml=yes
+class cmValgrindXMLParser : public cmXMLParser
+{
+public:
+  cmValgrindXMLParser(cmCTest* c)
+  {
+    this->CTest = c;
+    this->SetErrorCallback(xmlReportError, (void*)c);
+    this->InError = false;
+  }
+  struct Error
+  {
+    std::string Kind;
+    std::string What;
+    std::string Stack;
+  };
+  void StartElement(const std::string& name, const char**)
+  {
+    if (name == "error") {
+      this->InError = true;
+      this->Current = Error();
+    } else if (name == "frame") {
+      this->Frame.clear();
+    }
+    this->Data = "";
+  }
+  void CharacterDataHandler(const char* data, int length)
+  {
+    this->Data.append(data, length);
+  }
+  void EndElement(const std::string& name)
+  {
+    if (!this->InError) {
+      return;
+    }
+    if (name == "error") {
+      this->Errors.push_back(this->Current);
+      this->InError = false;
+    } else if (name == "kind") {
+      this->Current.Kind = this->Data;
+    } else if (name == "what" ||
+               (name == "text" && this->Current.What.empty())) {
+      // Leaks describe themselves in <xwhat><text>.
+      this->Current.What = this->Data;
+    } else if (name == "frame") {
+      // Format the frame like the text output does.
+      this->Current.Stack += this->Current.Stack.empty() ? "   at " : "   by ";
+      this->Current.Stack += this->Frame["ip"] + ": ";
+      this->Current.Stack +=
+        this->Frame["fn"].empty() ? "???" : this->Frame["fn"];
+      if (!this->Frame["file"].empty()) {
+        this->Current.Stack +=
+          " (" + this->Frame["file"] + ":" + this->Frame["line"] + ")";
+      } else if (!this->Frame["obj"].empty()) {
+        this->Current.Stack += " (in " + this->Frame["obj"] + ")";
+      }
+      this->Current.Stack += "\n";
+    } else {
+      this->Frame[name] = this->Data;
+    }
+  }
+  cmCTest* CTest;
+  std::vector<Error> Errors;
+
+private:
+  bool InError;
+  Error Current;
+  std::map<std::string, std::string> Frame;
+  std::string Data;
+};
+
+// Return whether a line of output starts with the "==<pid>==" prefix
+// used by valgrind.
+static bool cmCTestMemCheckIsValgrindLine(const char* line, size_t len)
+{
+  if (len < 5 || line[0] != '=' || line[1] != '=' || !isdigit(line[2])) {
+    return false;
+  }
+  size_t i = 3;
+  while (i < len && isdigit(line[i])) {
+    ++i;
+  }
+  return i + 1 < len && line[i] == '=' && line[i + 1] == '=';
+}
+
 #define BOUNDS_CHECKER_MARKER                                                 \
   "******######*****Begin BOUNDS CHECKER XML******######******"
 
@@ -128,6 +269,10 @@ cmCTestMemCheckHandler::cmCTestMemCheckHandler()
   this->CustomMaximumPassedTestOutputSize = 0;
   this->CustomMaximumFailedTestOutputSize = 0;
   this->LogWithPID = false;
+  for (CatToErrorType* ptr = cmCTestMemCheckValgrindText; ptr->ErrorCategory;
+       ++ptr) {
+    this->ValgrindDefectRegex.Add(0, ptr->ErrorCategory);
+  }
 }
 
 void cmCTestMemCheckHandler::Initialize()
@@ -539,7 +684,14 @@ bool cmCTestMemCheckHandler::InitializeMemoryChecking()
           this->CTest->GetCTestConfiguration("MemoryCheckSuppressionFile");
         this->MemoryTesterOptions.push_back(suppressions);
       }
-      std::string outputFile = "--log-file=" + this->MemoryTesterOutputFile;
+      // With --xml=yes valgrind reports errors only in its XML output.
+      std::string outputFile = "--log-file=";
+      if (std::find(this->MemoryTesterOptions.begin(),
+                    this->MemoryTesterOptions.end(),
+                    "--xml=yes") != this->MemoryTesterOptions.end()) {
+        outputFile = "--xml-file=";
+      }
+      outputFile += this->MemoryTesterOutputFile;
       this->MemoryTesterDynamicOptions.push_back(outputFile);
       break;
     }
@@ -770,99 +922,112 @@ bool cmCTestMemCheckHandler::ProcessMemCheckPurifyOutput(
 bool cmCTestMemCheckHandler::ProcessMemCheckValgrindOutput(
   const std::string& str, std::string& log, std::vector<int>& results)
 {
-  std::vector<std::string> lines;
-  cmSystemTools::Split(str.c_str(), lines);
   bool unlimitedOutput = false;
   if (str.find("CTEST_FULL_OUTPUT") != str.npos ||
       this->CustomMaximumFailedTestOutputSize == 0) {
     unlimitedOutput = true;
   }
 
-  std::string::size_type cc;
-
   std::ostringstream ostr;
   log = "";
 
   int defects = 0;
 
-  cmsys::RegularExpression valgrindLine("^==[0-9][0-9]*==");
-
-  cmsys::RegularExpression vgFIM(
-    "== .*Invalid free\\(\\) / delete / delete\\[\\]");
-  cmsys::RegularExpression vgFMM(
-    "== .*Mismatched free\\(\\) / delete / delete \\[\\]");
-  cmsys::RegularExpression vgMLK1(
-    "== .*[0-9,]+ bytes in [0-9,]+ blocks are definitely lost"
-    " in loss record [0-9,]+ of [0-9,]+");
-  cmsys::RegularExpression vgMLK2(
-    "== .*[0-9,]+ \\([0-9,]+ direct, [0-9,]+ indirect\\)"
-    " bytes in [0-9,]+ blocks are definitely lost"
-    " in loss record [0-9,]+ of [0-9,]+");
-  cmsys::RegularExpression vgPAR(
-    "== .*Syscall param .* (contains|points to) unaddressable byte\\(s\\)");
-  cmsys::RegularExpression vgMPK1(
-    "== .*[0-9,]+ bytes in [0-9,]+ blocks are possibly lost in"
-    " loss record [0-9,]+ of [0-9,]+");
-  cmsys::RegularExpression vgMPK2(
-    "== .*[0-9,]+ bytes in [0-9,]+ blocks are still reachable"
-    " in loss record [0-9,]+ of [0-9,]+");
-  cmsys::RegularExpression vgUMC(
-    "== .*Conditional jump or move depends on uninitialised value\\(s\\)");
-  cmsys::RegularExpression vgUMR1(
-    "== .*Use of uninitialised value of size [0-9,]+");
-  cmsys::RegularExpression vgUMR2("== .*Invalid read of size [0-9,]+");
-  cmsys::RegularExpression vgUMR3("== .*Jump to the invalid address ");
-  cmsys::RegularExpression vgUMR4(
-    "== .*Syscall param .* contains "
-    "uninitialised or unaddressable byte\\(s\\)");
-  cmsys::RegularExpression vgUMR5("== .*Syscall param .* uninitialised");
-  cmsys::RegularExpression vgIPW("== .*Invalid write of size [0-9,]+");
-  cmsys::RegularExpression vgABR("== .*pthread_mutex_unlock: mutex is "
-                                 "locked by a different thread");
-  std::vector<std::string::size_type> nonValGrindOutput;
   double sttime = cmSystemTools::GetTime();
-  cmCTestOptionalLog(this->CTest, DEBUG,
-                     "Start test: " << lines.size() << std::endl, this->Quiet);
+  cmCTestOptionalLog(this->CTest, DEBUG, "Start test: " << str.size()
+                                                        << std::endl,
+                     this->Quiet);
   std::string::size_type totalOutputSize = 0;
-  for (cc = 0; cc < lines.size(); cc++) {
-    cmCTestOptionalLog(this->CTest, DEBUG,
-                       "test line " << lines[cc] << std::endl, this->Quiet);
 
-    if (valgrindLine.find(lines[cc])) {
+  // Valgrind run with --xml=yes reports its errors in an XML document
+  // appended to the output.  Its kind classifies each error exactly.
+  std::string::size_type xmlBegin = str.find("<valgrindoutput>");
+  std::string::size_type xmlEnd = xmlBegin;
+  if (xmlBegin != str.npos) {
+    std::string::size_type decl = str.rfind("<?xml", xmlBegin);
+    if (decl != str.npos && (decl == 0 || str[decl - 1] == '\n')) {
+      std::string::size_type declEnd = str.find("?>", decl);
+      if (declEnd != str.npos &&
+          str.find_first_not_of(" \t\r\n", declEnd + 2) == xmlBegin) {
+        xmlBegin = decl;
+      }
+    }
+    xmlEnd = str.find("</valgrindoutput>", xmlBegin);
+    xmlEnd = (xmlEnd == str.npos) ? str.size()
+                                  : xmlEnd + strlen("</valgrindoutput>");
+
+    cmValgrindXMLParser parser(this->CTest);
+    parser.InitializeParser();
+    parser.ParseChunk(str.c_str() + xmlBegin,
+                      static_cast<unsigned int>(xmlEnd - xmlBegin));
+    parser.CleanupParser();
+    for (std::vector<cmValgrindXMLParser::Error>::const_iterator ei =
+           parser.Errors.begin();
+         ei != parser.Errors.end(); ++ei) {
+      int failure = cmCTestMemCheckHandler::NO_MEMORY_FAULT;
+      CatToErrorType* ptr = cmCTestMemCheckValgrindKinds;
+      while (ptr->ErrorCategory && ei->Kind != ptr->ErrorCategory) {
+        ++ptr;
+      }
+      if (ptr->ErrorCategory) {
+        failure = ptr->ErrorCode;
+      } else {
+        std::string what = "== " + ei->What;
+        this->ValgrindDefectRegex.Scan(what.c_str());
+        int idx = this->ValgrindDefectRegex.Find(0, what.c_str());
+        if (idx >= 0) {
+          failure = cmCTestMemCheckValgrindText[idx].ErrorCode;
+        }
+      }
+      if (failure != cmCTestMemCheckHandler::NO_MEMORY_FAULT) {
+        ostr << "<b>" << this->ResultStrings[failure] << "</b> ";
+        results[failure]++;
+        defects++;
+      }
+      totalOutputSize += ei->What.size() + ei->Stack.size();
+      ostr << ei->What << std::endl << ei->Stack;
+    }
+  }
+
+  // Scan the text output line by line without copying it.  Lines with
+  // the valgrind prefix go first; the rest is kept for afterwards.
+  std::vector<std::pair<const char*, size_t> > nonValGrindOutput;
+  std::string::size_type const segmentBegin[2] = { 0, xmlEnd };
+  std::string::size_type const segmentEnd[2] = { xmlBegin, str.size() };
+  for (int segment = 0; segment < 2; ++segment) {
+    std::string::size_type pos = segmentBegin[segment];
+    std::string::size_type end = segmentEnd[segment];
+    if (end > str.size()) {
+      end = str.size();
+    }
+    while (pos < end) {
+      std::string::size_type eol = str.find('\n', pos);
+      if (eol == str.npos || eol > end) {
+        eol = end;
+      }
+      const char* line = str.c_str() + pos;
+      size_t len = eol - pos;
+      if (len > 0 && line[len - 1] == '\r') {
+        --len;
+      }
+      pos = eol + 1;
+
+      if (!cmCTestMemCheckIsValgrindLine(line, len)) {
+        nonValGrindOutput.push_back(std::make_pair(line, len));
+        continue;
+      }
+      std::string vgLine(line, len);
       cmCTestOptionalLog(this->CTest, DEBUG,
-                         "valgrind  line " << lines[cc] << std::endl,
+                         "valgrind  line " << vgLine << std::endl,
                          this->Quiet);
+      // Errors reported in XML do not also appear in the text output.
       int failure = cmCTestMemCheckHandler::NO_MEMORY_FAULT;
-      if (vgFIM.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::FIM;
-      } else if (vgFMM.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::FMM;
-      } else if (vgMLK1.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::MLK;
-      } else if (vgMLK2.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::MLK;
-      } else if (vgPAR.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::PAR;
-      } else if (vgMPK1.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::MPK;
-      } else if (vgMPK2.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::MPK;
-      } else if (vgUMC.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::UMC;
-      } else if (vgUMR1.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR2.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR3.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR4.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR5.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgIPW.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::IPW;
-      } else if (vgABR.find(lines[cc])) {
-        failure = cmCTestMemCheckHandler::ABR;
+      if (xmlBegin == str.npos) {
+        this->ValgrindDefectRegex.Scan(vgLine.c_str());
+        int idx = this->ValgrindDefectRegex.Find(0, vgLine.c_str());
+        if (idx >= 0) {
+          failure = cmCTestMemCheckValgrindText[idx].ErrorCode;
+        }
       }
 
       if (failure != cmCTestMemCheckHandler::NO_MEMORY_FAULT) {
@@ -870,20 +1035,19 @@ bool cmCTestMemCheckHandler::ProcessMemCheckValgrindOutput(
         results[failure]++;
         defects++;
       }
-      totalOutputSize += lines[cc].size();
-      ostr << lines[cc] << std::endl;
-    } else {
-      nonValGrindOutput.push_back(cc);
+      totalOutputSize += len;
+      ostr << vgLine << std::endl;
     }
   }
   // Now put all all the non valgrind output into the test output
   // This should be last in case it gets truncated by the output
   // limiting code
-  for (std::vector<std::string::size_type>::iterator i =
+  for (std::vector<std::pair<const char*, size_t> >::iterator i =
          nonValGrindOutput.begin();
        i != nonValGrindOutput.end(); ++i) {
-    totalOutputSize += lines[*i].size();
-    ostr << lines[*i] << std::endl;
+    totalOutputSize += i->second;
+    ostr.write(i->first, i->second);
+    ostr << std::endl;
     if (!unlimitedOutput &&
         totalOutputSize >
           static_cast<size_t>(this->CustomMaximumFailedTestOutputSize)) {
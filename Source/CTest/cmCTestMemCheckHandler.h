@@ -15,6 +15,7 @@
 
 #include "cmCTestTestHandler.h"
 
+#include "cmCTestRegexSet.h"
 #include "cmListFileCache.h"
 #include <string>
 #include <vector>
@@ -113,6 +114,8 @@ private:
   std::vector<std::string> ResultStringsLong;
   std::vector<int> GlobalResults;
   bool LogWithPID; // does log file add pid
+  // precompiled expressions for valgrind text output defects
+  cmCTestRegexSet ValgrindDefectRegex;
 
   std::vector<int>::size_type FindOrAddWarning(const std::string& warning);
   // initialize the ResultStrings and ResultStringsLong for
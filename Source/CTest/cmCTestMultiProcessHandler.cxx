@@ -12,7 +12,6 @@
 #include "cmCTestMultiProcessHandler.h"
 
 #include "cmCTest.h"
-#include "cmCTestScriptHandler.h"
 #include "cmProcess.h"
 #include "cmStandardIncludes.h"
 #include "cmSystemTools.h"
@@ -24,6 +23,9 @@
 #include <stack>
 #include <stdlib.h>
 
+// Minimum time in seconds between two samples of the system load.
+static const double LoadSampleInterval = 1.0;
+
 class TestComparator
 {
 public:
@@ -53,6 +55,11 @@ cmCTestMultiProcessHandler::cmCTestMultiProcessHandler()
   this->StopTimePassed = false;
   this->HasCycles = false;
   this->SerialTestRunning = false;
+  this->SystemLoad = 0;
+  this->LoadSampleTime = -1;
+  this->UsedFakeLoadForTesting = false;
+  this->WaitingForLoad = false;
+  this->WaitingLoad = 0;
 }
 
 cmCTestMultiProcessHandler::~cmCTestMultiProcessHandler()
@@ -66,6 +73,23 @@ void cmCTestMultiProcessHandler::SetTests(TestMap& tests,
   this->Tests = tests;
   this->Properties = properties;
   this->Total = this->Tests.size();
+  // index tests by name, the last test with a given name wins
+  for (PropertiesMap::iterator i = this->Properties.begin();
+       i != this->Properties.end(); ++i) {
+    this->TestIndexByName[i->second->Name] = i->first;
+  }
+  // size each resource pool to the smallest size any test gives it
+  for (PropertiesMap::iterator i = this->Properties.begin();
+       i != this->Properties.end(); ++i) {
+    std::map<std::string, int> const& pools = i->second->ResourcePools;
+    for (std::map<std::string, int>::const_iterator p = pools.begin();
+         p != pools.end(); ++p) {
+      std::vector<bool>& slots = this->ResourcePoolSlots[p->first];
+      if (slots.empty() || slots.size() > static_cast<size_t>(p->second)) {
+        slots.assign(p->second, false);
+      }
+    }
+  }
   // set test run map to false for all
   for (TestMap::iterator i = this->Tests.begin(); i != this->Tests.end();
        ++i) {
@@ -137,6 +161,7 @@ void cmCTestMultiProcessHandler::StartTestProcess(int test)
 
   // Lock the resources we'll be using
   this->LockResources(test);
+  testRun->SetResourcePoolSlots(this->ResourcePoolAllocations[test]);
 
   if (testRun->StartTest(this->Total)) {
     this->RunningTests.insert(testRun);
@@ -169,6 +194,21 @@ void cmCTestMultiProcessHandler::LockResources(int index)
     this->Properties[index]->LockedResources.begin(),
     this->Properties[index]->LockedResources.end());
 
+  // Take the first free slot of each resource pool
+  std::map<std::string, int> const& pools =
+    this->Properties[index]->ResourcePools;
+  std::map<std::string, int>& allocated = this->ResourcePoolAllocations[index];
+  for (std::map<std::string, int>::const_iterator p = pools.begin();
+       p != pools.end(); ++p) {
+    std::vector<bool>& slots = this->ResourcePoolSlots[p->first];
+    std::vector<bool>::iterator slot =
+      std::find(slots.begin(), slots.end(), false);
+    if (slot != slots.end()) {
+      *slot = true;
+      allocated[p->first] = static_cast<int>(slot - slots.begin());
+    }
+  }
+
   if (this->Properties[index]->RunSerial) {
     this->SerialTestRunning = true;
   }
@@ -181,6 +221,16 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
        i != this->Properties[index]->LockedResources.end(); ++i) {
     this->LockedResources.erase(*i);
   }
+  std::map<int, std::map<std::string, int> >::iterator allocated =
+    this->ResourcePoolAllocations.find(index);
+  if (allocated != this->ResourcePoolAllocations.end()) {
+    for (std::map<std::string, int>::const_iterator p =
+           allocated->second.begin();
+         p != allocated->second.end(); ++p) {
+      this->ResourcePoolSlots[p->first][p->second] = false;
+    }
+    this->ResourcePoolAllocations.erase(allocated);
+  }
   if (this->Properties[index]->RunSerial) {
     this->SerialTestRunning = false;
   }
@@ -220,6 +270,17 @@ bool cmCTestMultiProcessHandler::StartTest(int test)
     }
   }
 
+  // Check for a free slot in each resource pool
+  std::map<std::string, int> const& pools =
+    this->Properties[test]->ResourcePools;
+  for (std::map<std::string, int>::const_iterator p = pools.begin();
+       p != pools.end(); ++p) {
+    std::vector<bool> const& slots = this->ResourcePoolSlots[p->first];
+    if (std::find(slots.begin(), slots.end(), false) == slots.end()) {
+      return false;
+    }
+  }
+
   // if there are no depends left then run this test
   if (this->Tests[test].empty()) {
     this->StartTestProcess(test);
@@ -248,31 +309,16 @@ void cmCTestMultiProcessHandler::StartNextTests()
   }
 
   bool allTestsFailedTestLoadCheck = false;
-  bool usedFakeLoadForTesting = false;
   size_t minProcessorsRequired = this->ParallelLevel;
   std::string testWithMinProcessors = "";
 
-  cmsys::SystemInformation info;
-
   unsigned long systemLoad = 0;
   size_t spareLoad = 0;
   if (this->TestLoad > 0) {
     // Activate possible wait.
     allTestsFailedTestLoadCheck = true;
 
-    // Check for a fake load average value used in testing.
-    if (const char* fake_load_value =
-          cmSystemTools::GetEnv("__CTEST_FAKE_LOAD_AVERAGE_FOR_TESTING")) {
-      usedFakeLoadForTesting = true;
-      if (!cmSystemTools::StringToULong(fake_load_value, &systemLoad)) {
-        cmSystemTools::Error("Failed to parse fake load value: ",
-                             fake_load_value);
-      }
-    }
-    // If it's not set, look up the true load average.
-    else {
-      systemLoad = static_cast<unsigned long>(ceil(info.GetLoadAverage()));
-    }
+    systemLoad = this->GetSystemLoad();
     spareLoad =
       (this->TestLoad > systemLoad ? this->TestLoad - systemLoad : 0);
 
@@ -323,7 +369,15 @@ void cmCTestMultiProcessHandler::StartNextTests()
     }
   }
 
-  if (allTestsFailedTestLoadCheck) {
+  if (!allTestsFailedTestLoadCheck) {
+    this->WaitingForLoad = false;
+    return;
+  }
+
+  // Report the wait once, and again whenever the load changes.
+  if (!this->WaitingForLoad || systemLoad != this->WaitingLoad) {
+    this->WaitingForLoad = true;
+    this->WaitingLoad = systemLoad;
     cmCTestLog(this->CTest, HANDLER_OUTPUT, "***** WAITING, ");
     if (this->SerialTestRunning) {
       cmCTestLog(this->CTest, HANDLER_OUTPUT,
@@ -338,19 +392,53 @@ void cmCTestMultiProcessHandler::StartNextTests()
       /* clang-format on */
     }
     cmCTestLog(this->CTest, HANDLER_OUTPUT, "*****" << std::endl);
+  }
 
-    if (usedFakeLoadForTesting) {
-      // Break out of the infinite loop of waiting for our fake load
-      // to come down.
-      this->StopTimePassed = true;
-    } else {
-      // Wait between 1 and 5 seconds before trying again.
-      cmCTestScriptHandler::SleepInSeconds(cmSystemTools::RandomSeed() % 5 +
-                                           1);
+  if (this->UsedFakeLoadForTesting) {
+    // Break out of the infinite loop of waiting for our fake load
+    // to come down.
+    this->StopTimePassed = true;
+  } else if (this->RunningTests.empty()) {
+    // Nothing to collect output from, so wait until the load can be
+    // sampled again.  Otherwise the main loop keeps collecting output
+    // and we try again as soon as a test finishes or the load drops.
+    double wait = this->LoadSampleTime + LoadSampleInterval -
+      cmSystemTools::GetTime();
+    if (wait > 0) {
+      cmSystemTools::Delay(static_cast<unsigned int>(wait * 1000) + 1);
     }
   }
 }
 
+unsigned long cmCTestMultiProcessHandler::GetSystemLoad()
+{
+  // The load average changes slowly, so sample it at most once per
+  // interval and reuse the value in between.
+  double now = cmSystemTools::GetTime();
+  if (this->LoadSampleTime >= 0 &&
+      now < this->LoadSampleTime + LoadSampleInterval) {
+    return this->SystemLoad;
+  }
+  this->LoadSampleTime = now;
+
+  // Check for a fake load average value used in testing.
+  if (const char* fake_load_value =
+        cmSystemTools::GetEnv("__CTEST_FAKE_LOAD_AVERAGE_FOR_TESTING")) {
+    this->UsedFakeLoadForTesting = true;
+    if (!cmSystemTools::StringToULong(fake_load_value, &this->SystemLoad)) {
+      cmSystemTools::Error("Failed to parse fake load value: ",
+                           fake_load_value);
+    }
+  }
+  // If it's not set, look up the true load average.
+  else {
+    cmsys::SystemInformation info;
+    this->SystemLoad =
+      static_cast<unsigned long>(ceil(info.GetLoadAverage()));
+  }
+  return this->SystemLoad;
+}
+
 bool cmCTestMultiProcessHandler::CheckOutput()
 {
   // no more output we are done
@@ -383,6 +471,7 @@ bool cmCTestMultiProcessHandler::CheckOutput()
     } else {
       this->Failed->push_back(p->GetTestProperties()->Name);
     }
+    this->RecordCostData(test);
     for (TestMap::iterator j = this->Tests.begin(); j != this->Tests.end();
          ++j) {
       j->second.erase(test);
@@ -398,51 +487,115 @@ bool cmCTestMultiProcessHandler::CheckOutput()
   return true;
 }
 
+// A line of the cost data file or its journal.
+// Format: <name> <previous_runs> <avg_cost> [<cost_variance>]
+struct cmCTestCostRecord
+{
+  std::string Name;
+  int PreviousRuns;
+  double AverageCost;
+  double CostVariance;
+
+  bool Parse(std::string const& line)
+  {
+    std::vector<cmsys::String> parts = cmSystemTools::SplitString(line, ' ');
+    if (parts.size() < 3) {
+      return false;
+    }
+    this->Name = parts[0];
+    this->PreviousRuns = atoi(parts[1].c_str());
+    this->AverageCost = atof(parts[2].c_str());
+    this->CostVariance = parts.size() > 3 ? atof(parts[3].c_str()) : 0;
+    return true;
+  }
+};
+
+static void cmCTestWriteCostRecord(std::ostream& os, std::string const& name,
+                                   int prev, double cost, double variance)
+{
+  os << name << " " << prev << " " << static_cast<float>(cost) << " "
+     << static_cast<float>(variance) << "\n";
+}
+
+std::string cmCTestMultiProcessHandler::GetCostJournalFile()
+{
+  return this->CTest->GetCostDataFile() + ".journal";
+}
+
+void cmCTestMultiProcessHandler::RecordCostData(int index)
+{
+  // Append the new statistics of a finished test to the journal so
+  // they survive even if this run does not complete.
+  if (!this->CostJournal.is_open()) {
+    std::string jname = this->GetCostJournalFile();
+    this->CostJournal.open(jname.c_str(), std::ios::app);
+  }
+  cmCTestTestHandler::cmCTestTestProperties* p = this->Properties[index];
+  cmCTestWriteCostRecord(this->CostJournal, p->Name, p->PreviousRuns,
+                         p->AverageCost, p->CostVariance);
+  this->CostJournal.flush();
+}
+
 void cmCTestMultiProcessHandler::UpdateCostData()
 {
   std::string fname = this->CTest->GetCostDataFile();
+  std::string jname = this->GetCostJournalFile();
   std::string tmpout = fname + ".tmp";
-  cmsys::ofstream fout;
-  fout.open(tmpout.c_str());
-
-  PropertiesMap temp = this->Properties;
 
-  if (cmSystemTools::FileExists(fname.c_str())) {
+  // Load the previous records, in order, and merge in the journal of
+  // this run or of an earlier one that did not complete.
+  std::vector<cmCTestCostRecord> records;
+  TestNameMap recordIndex;
+  std::string const* files[] = { &fname, &jname };
+  for (size_t f = 0; f < sizeof(files) / sizeof(files[0]); ++f) {
+    if (!cmSystemTools::FileExists(files[f]->c_str())) {
+      continue;
+    }
     cmsys::ifstream fin;
-    fin.open(fname.c_str());
-
+    fin.open(files[f]->c_str());
     std::string line;
     while (std::getline(fin, line)) {
       if (line == "---")
         break;
-      std::vector<cmsys::String> parts = cmSystemTools::SplitString(line, ' ');
-      // Format: <name> <previous_runs> <avg_cost>
-      if (parts.size() < 3)
+      cmCTestCostRecord record;
+      if (!record.Parse(line))
         break;
-
-      std::string name = parts[0];
-      int prev = atoi(parts[1].c_str());
-      float cost = static_cast<float>(atof(parts[2].c_str()));
-
-      int index = this->SearchByName(name);
-      if (index == -1) {
-        // This test is not in memory. We just rewrite the entry
-        fout << name << " " << prev << " " << cost << "\n";
+      std::pair<TestNameMap::iterator, bool> ins = recordIndex.insert(
+        std::make_pair(record.Name, static_cast<int>(records.size())));
+      if (ins.second) {
+        records.push_back(record);
       } else {
-        // Update with our new average cost
-        fout << name << " " << this->Properties[index]->PreviousRuns << " "
-             << this->Properties[index]->Cost << "\n";
-        temp.erase(index);
+        records[ins.first->second] = record;
       }
     }
-    fin.close();
-    cmSystemTools::RemoveFile(fname);
+  }
+  this->CostJournal.close();
+
+  cmsys::ofstream fout;
+  fout.open(tmpout.c_str());
+
+  PropertiesMap temp = this->Properties;
+
+  for (std::vector<cmCTestCostRecord>::const_iterator r = records.begin();
+       r != records.end(); ++r) {
+    int index = this->SearchByName(r->Name);
+    if (index == -1) {
+      // This test is not in memory. We just rewrite the entry
+      cmCTestWriteCostRecord(fout, r->Name, r->PreviousRuns, r->AverageCost,
+                             r->CostVariance);
+    } else {
+      // Update with our new average cost
+      cmCTestTestHandler::cmCTestTestProperties* p = this->Properties[index];
+      cmCTestWriteCostRecord(fout, p->Name, p->PreviousRuns, p->AverageCost,
+                             p->CostVariance);
+      temp.erase(index);
+    }
   }
 
   // Add all tests not previously listed in the file
   for (PropertiesMap::iterator i = temp.begin(); i != temp.end(); ++i) {
-    fout << i->second->Name << " " << i->second->PreviousRuns << " "
-         << i->second->Cost << "\n";
+    cmCTestWriteCostRecord(fout, i->second->Name, i->second->PreviousRuns,
+                           i->second->AverageCost, i->second->CostVariance);
   }
 
   // Write list of failed tests
@@ -452,7 +605,9 @@ void cmCTestMultiProcessHandler::UpdateCostData()
     fout << *i << "\n";
   }
   fout.close();
+  cmSystemTools::RemoveFile(fname);
   cmSystemTools::RenameFile(tmpout.c_str(), fname.c_str());
+  cmSystemTools::RemoveFile(jname);
 }
 
 void cmCTestMultiProcessHandler::ReadCostData()
@@ -463,54 +618,66 @@ void cmCTestMultiProcessHandler::ReadCostData()
     cmsys::ifstream fin;
     fin.open(fname.c_str());
     std::string line;
+    bool valid = true;
     while (std::getline(fin, line)) {
       if (line == "---")
         break;
 
-      std::vector<cmsys::String> parts = cmSystemTools::SplitString(line, ' ');
-
+      cmCTestCostRecord record;
       // Probably an older version of the file, will be fixed next run
-      if (parts.size() < 3) {
-        fin.close();
-        return;
-      }
-
-      std::string name = parts[0];
-      int prev = atoi(parts[1].c_str());
-      float cost = static_cast<float>(atof(parts[2].c_str()));
-
-      int index = this->SearchByName(name);
-      if (index == -1)
-        continue;
-
-      this->Properties[index]->PreviousRuns = prev;
-      // When not running in parallel mode, don't use cost data
-      if (this->ParallelLevel > 1 && this->Properties[index] &&
-          this->Properties[index]->Cost == 0) {
-        this->Properties[index]->Cost = cost;
+      if (!record.Parse(line)) {
+        valid = false;
+        break;
       }
+      this->ApplyCostRecord(record);
     }
     // Next part of the file is the failed tests
-    while (std::getline(fin, line)) {
+    while (valid && std::getline(fin, line)) {
       if (line != "") {
-        this->LastTestsFailed.push_back(line);
+        this->LastTestsFailed.insert(line);
       }
     }
     fin.close();
   }
+
+  // Apply the statistics recorded by a run that did not complete.
+  std::string jname = this->GetCostJournalFile();
+  if (cmSystemTools::FileExists(jname.c_str(), true)) {
+    cmsys::ifstream fin;
+    fin.open(jname.c_str());
+    std::string line;
+    cmCTestCostRecord record;
+    while (std::getline(fin, line) && record.Parse(line)) {
+      this->ApplyCostRecord(record);
+    }
+    fin.close();
+  }
 }
 
-int cmCTestMultiProcessHandler::SearchByName(std::string const& name)
+void cmCTestMultiProcessHandler::ApplyCostRecord(
+  cmCTestCostRecord const& record)
 {
-  int index = -1;
+  int index = this->SearchByName(record.Name);
+  if (index == -1)
+    return;
 
-  for (PropertiesMap::iterator i = this->Properties.begin();
-       i != this->Properties.end(); ++i) {
-    if (i->second->Name == name) {
-      index = i->first;
-    }
+  cmCTestTestHandler::cmCTestTestProperties* p = this->Properties[index];
+  p->PreviousRuns = record.PreviousRuns;
+  p->AverageCost = record.AverageCost;
+  p->CostVariance = record.CostVariance;
+  // When not running in parallel mode, don't use cost data
+  if (this->ParallelLevel > 1 && p->Cost == 0) {
+    p->Cost = static_cast<float>(record.AverageCost);
+  }
+}
+
+int cmCTestMultiProcessHandler::SearchByName(std::string const& name)
+{
+  TestNameMap::const_iterator i = this->TestIndexByName.find(name);
+  if (i == this->TestIndexByName.end()) {
+    return -1;
   }
-  return index;
+  return i->second;
 }
 
 void cmCTestMultiProcessHandler::CreateTestCostList()
@@ -534,8 +701,7 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
   // of the cost list and queue other tests for further sorting
   for (TestMap::const_iterator i = this->Tests.begin(); i != this->Tests.end();
        ++i) {
-    if (std::find(this->LastTestsFailed.begin(), this->LastTestsFailed.end(),
-                  this->Properties[i->first]->Name) !=
+    if (this->LastTestsFailed.find(this->Properties[i->first]->Name) !=
         this->LastTestsFailed.end()) {
       // If the test failed last time, it should be run first.
       this->SortedTests.push_back(i->first);
@@ -772,7 +938,14 @@ void cmCTestMultiProcessHandler::CheckResume()
 void cmCTestMultiProcessHandler::RemoveTest(int index)
 {
   this->EraseTest(index);
-  this->Properties.erase(index);
+  PropertiesMap::iterator p = this->Properties.find(index);
+  if (p != this->Properties.end()) {
+    TestNameMap::iterator n = this->TestIndexByName.find(p->second->Name);
+    if (n != this->TestIndexByName.end() && n->second == index) {
+      this->TestIndexByName.erase(n);
+    }
+    this->Properties.erase(p);
+  }
   this->TestRunningMap[index] = false;
   this->TestFinishMap[index] = true;
   this->Completed++;
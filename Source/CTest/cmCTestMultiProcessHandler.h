@@ -16,6 +16,18 @@
 
 #include <cmCTestRunTest.h>
 
+#include <cmsys/FStream.hxx>
+
+#ifdef CMake_HAVE_CXX11_UNORDERED_MAP
+#include <unordered_map>
+#include <unordered_set>
+#else
+#include <cmsys/hash_map.hxx>
+#include <cmsys/hash_set.hxx>
+#endif
+
+struct cmCTestCostRecord;
+
 /** \class cmCTestMultiProcessHandler
  * \brief run parallel ctest
  *
@@ -39,6 +51,13 @@ public:
     : public std::map<int, cmCTestTestHandler::cmCTestTestProperties*>
   {
   };
+#ifdef CMake_HAVE_CXX11_UNORDERED_MAP
+  typedef std::unordered_map<std::string, int> TestNameMap;
+  typedef std::unordered_set<std::string> TestNameSet;
+#else
+  typedef cmsys::hash_map<std::string, int> TestNameMap;
+  typedef cmsys::hash_set<std::string> TestNameSet;
+#endif
 
   cmCTestMultiProcessHandler();
   virtual ~cmCTestMultiProcessHandler();
@@ -81,8 +100,13 @@ protected:
   // Mark the checkpoint for the given test
   void WriteCheckpoint(int index);
 
+  // Rewrite the cost data file with the statistics of this run
   void UpdateCostData();
   void ReadCostData();
+  void ApplyCostRecord(cmCTestCostRecord const& record);
+  // Append the statistics of a finished test to the cost journal
+  void RecordCostData(int index);
+  std::string GetCostJournalFile();
   // Return index of a test based on its name
   int SearchByName(std::string const& name);
 
@@ -106,6 +130,8 @@ protected:
   bool CheckCycles();
   int FindMaxIndex();
   inline size_t GetProcessorsUsed(int index);
+  // Return the system load, sampled at most once per interval
+  unsigned long GetSystemLoad();
   std::string GetName(int index);
 
   void LockResources(int index);
@@ -121,16 +147,29 @@ protected:
   bool StopTimePassed;
   // list of test properties (indices concurrent to the test map)
   PropertiesMap Properties;
+  // index of each test by name
+  TestNameMap TestIndexByName;
   std::map<int, bool> TestRunningMap;
   std::map<int, bool> TestFinishMap;
   std::map<int, std::string> TestOutput;
   std::vector<std::string>* Passed;
   std::vector<std::string>* Failed;
-  std::vector<std::string> LastTestsFailed;
+  TestNameSet LastTestsFailed;
+  cmsys::ofstream CostJournal;
   std::set<std::string> LockedResources;
+  // slots of each resource pool, true if in use
+  std::map<std::string, std::vector<bool> > ResourcePoolSlots;
+  // slot of each resource pool given to each running test
+  std::map<int, std::map<std::string, int> > ResourcePoolAllocations;
   std::vector<cmCTestTestHandler::cmCTestTestResult>* TestResults;
   size_t ParallelLevel; // max number of process that can be run at once
   unsigned long TestLoad;
+  unsigned long SystemLoad;
+  double LoadSampleTime;
+  bool UsedFakeLoadForTesting;
+  // Whether tests are held back by the load, and at which load
+  bool WaitingForLoad;
+  unsigned long WaitingLoad;
   std::set<cmCTestRunTest*> RunningTests; // current running tests
   cmCTestTestHandler* TestHandler;
   cmCTest* CTest;
@@ -0,0 +1,247 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc.
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmCTestRegexSet.h"
+
+#include <string.h>
+
+// Return the longest literal string that every match of the given
+// regular expression must contain, or an empty string if none is known.
+static std::string cmCTestRegexSetRequiredLiteral(const char* regex)
+{
+  std::string best;
+  std::string run;
+  int depth = 0;
+  for (const char* p = regex; *p; ++p) {
+    if (*p == '[') {
+      // Skip a bracket expression.  A leading ']' is a literal member.
+      const char* q = p + 1;
+      if (*q == '^') {
+        ++q;
+      }
+      if (*q == ']') {
+        ++q;
+      }
+      q = strchr(q, ']');
+      if (!q) {
+        return std::string();
+      }
+      p = q;
+      if (depth == 0) {
+        if (run.size() > best.size()) {
+          best = run;
+        }
+        run = "";
+      }
+      continue;
+    }
+    if (depth > 0) {
+      // Groups may be optional or contain alternatives.  Only track their
+      // nesting.
+      if (*p == '\\' && p[1]) {
+        ++p;
+      } else if (*p == '(') {
+        ++depth;
+      } else if (*p == ')') {
+        --depth;
+      }
+      continue;
+    }
+    switch (*p) {
+      case '|':
+      case ')':
+        // Top-level alternatives share no required literal.
+        return std::string();
+      case '*':
+      case '?':
+        // The preceding character is optional.
+        if (!run.empty()) {
+          run.erase(run.size() - 1);
+        }
+        break;
+      case '+':
+        break;
+      case '(':
+        ++depth;
+        break;
+      case '.':
+      case '^':
+      case '$':
+        break;
+      case '\\':
+        if (!p[1]) {
+          return std::string();
+        }
+        ++p;
+        run += *p;
+        continue;
+      default:
+        run += *p;
+        continue;
+    }
+    if (run.size() > best.size()) {
+      best = run;
+    }
+    run = "";
+  }
+  if (run.size() > best.size()) {
+    best = run;
+  }
+  return best;
+}
+
+cmCTestRegexSet::cmCTestRegexSet()
+{
+  this->Clear();
+}
+
+void cmCTestRegexSet::Clear()
+{
+  this->Entries.clear();
+  this->Groups.clear();
+  this->Compiled = false;
+  memset(this->Class, 0, sizeof(this->Class));
+  this->NumberOfClasses = 1;
+  this->Delta.clear();
+  this->Output.clear();
+  this->Seen.clear();
+  this->Generation = 0;
+}
+
+void cmCTestRegexSet::Add(unsigned int group, std::string const& regex)
+{
+  if (this->Groups.size() <= group) {
+    this->Groups.resize(group + 1);
+  }
+  this->Groups[group].push_back(this->Entries.size());
+  this->Entries.push_back(Entry());
+  Entry& entry = this->Entries.back();
+  entry.Regex.compile(regex.c_str());
+  // Expressions that failed to compile are always evaluated so that
+  // they behave exactly as before.
+  if (entry.Regex.is_valid()) {
+    entry.Literal = cmCTestRegexSetRequiredLiteral(regex.c_str());
+  }
+  this->Compiled = false;
+}
+
+void cmCTestRegexSet::Compile()
+{
+  // Map the characters used by the literals to dense classes.  All other
+  // characters share class 0.
+  memset(this->Class, 0, sizeof(this->Class));
+  this->NumberOfClasses = 1;
+  for (std::vector<Entry>::const_iterator ei = this->Entries.begin();
+       ei != this->Entries.end(); ++ei) {
+    for (std::string::const_iterator ci = ei->Literal.begin();
+         ci != ei->Literal.end(); ++ci) {
+      unsigned char c = static_cast<unsigned char>(*ci);
+      if (!this->Class[c]) {
+        this->Class[c] = static_cast<unsigned char>(this->NumberOfClasses++);
+      }
+    }
+  }
+  size_t const nc = this->NumberOfClasses;
+
+  // Build the trie of literals.  A zero transition means "none" because
+  // no edge ever leads back to the root.
+  this->Delta.assign(nc, 0);
+  this->Output.assign(1, std::vector<size_t>());
+  for (size_t ei = 0; ei < this->Entries.size(); ++ei) {
+    std::string const& literal = this->Entries[ei].Literal;
+    if (literal.empty()) {
+      continue;
+    }
+    unsigned int state = 0;
+    for (std::string::const_iterator ci = literal.begin();
+         ci != literal.end(); ++ci) {
+      size_t t = state * nc + this->Class[static_cast<unsigned char>(*ci)];
+      if (!this->Delta[t]) {
+        this->Delta[t] = static_cast<unsigned int>(this->Output.size());
+        this->Delta.resize(this->Delta.size() + nc, 0);
+        this->Output.push_back(std::vector<size_t>());
+      }
+      state = this->Delta[t];
+    }
+    this->Output[state].push_back(ei);
+  }
+
+  // Complete the transitions breadth-first using the failure links and
+  // merge the outputs of each state's failure state into its own.
+  std::vector<unsigned int> fail(this->Output.size(), 0);
+  std::vector<unsigned int> queue;
+  for (size_t c = 0; c < nc; ++c) {
+    if (this->Delta[c]) {
+      queue.push_back(this->Delta[c]);
+    }
+  }
+  for (size_t qi = 0; qi < queue.size(); ++qi) {
+    unsigned int state = queue[qi];
+    std::vector<size_t> const& inherited = this->Output[fail[state]];
+    this->Output[state].insert(this->Output[state].end(), inherited.begin(),
+                               inherited.end());
+    for (size_t c = 0; c < nc; ++c) {
+      unsigned int& next = this->Delta[state * nc + c];
+      unsigned int fallback = this->Delta[fail[state] * nc + c];
+      if (next) {
+        fail[next] = fallback;
+        queue.push_back(next);
+      } else {
+        next = fallback;
+      }
+    }
+  }
+
+  this->Seen.assign(this->Entries.size(), 0);
+  this->Generation = 0;
+  this->Compiled = true;
+}
+
+void cmCTestRegexSet::Scan(const char* line)
+{
+  if (!this->Compiled) {
+    this->Compile();
+  }
+  if (++this->Generation == 0) {
+    this->Seen.assign(this->Entries.size(), 0);
+    this->Generation = 1;
+  }
+  size_t const nc = this->NumberOfClasses;
+  unsigned int state = 0;
+  for (const unsigned char* c = reinterpret_cast<const unsigned char*>(line);
+       *c; ++c) {
+    state = this->Delta[state * nc + this->Class[*c]];
+    std::vector<size_t> const& out = this->Output[state];
+    for (std::vector<size_t>::const_iterator oi = out.begin();
+         oi != out.end(); ++oi) {
+      this->Seen[*oi] = this->Generation;
+    }
+  }
+}
+
+int cmCTestRegexSet::Find(unsigned int group, const char* line)
+{
+  if (group >= this->Groups.size()) {
+    return -1;
+  }
+  std::vector<size_t> const& members = this->Groups[group];
+  for (size_t i = 0; i < members.size(); ++i) {
+    Entry& entry = this->Entries[members[i]];
+    if (!entry.Literal.empty() &&
+        this->Seen[members[i]] != this->Generation) {
+      continue;
+    }
+    if (entry.Regex.find(line)) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
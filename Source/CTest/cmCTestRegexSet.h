@@ -0,0 +1,71 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc.
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmCTestRegexSet_h
+#define cmCTestRegexSet_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+/** \class cmCTestRegexSet
+ * \brief Match a line against several groups of regular expressions.
+ *
+ * Most regular expressions used to scrape tool output contain a literal
+ * string that any matching line must contain.  These literals are
+ * compiled into a single Aho-Corasick automaton so that one pass over a
+ * line determines which expressions can possibly match it.  Only those,
+ * and the expressions without a required literal, are then evaluated.
+ */
+class cmCTestRegexSet
+{
+public:
+  cmCTestRegexSet();
+
+  /** Remove all expressions.  */
+  void Clear();
+
+  /** Append an expression to the given group.  */
+  void Add(unsigned int group, std::string const& regex);
+
+  /** Scan a line with the literal automaton.  Must be called before
+      Find is used for the same line.  */
+  void Scan(const char* line);
+
+  /** Return the index within the group of the first expression that
+      matches the line last given to Scan, or -1 if none matches.  */
+  int Find(unsigned int group, const char* line);
+
+private:
+  struct Entry
+  {
+    cmsys::RegularExpression Regex;
+    std::string Literal;
+  };
+  std::vector<Entry> Entries;
+  std::vector<std::vector<size_t> > Groups;
+
+  void Compile();
+  bool Compiled;
+
+  // Automaton transitions indexed by state and character class.
+  unsigned char Class[256];
+  size_t NumberOfClasses;
+  std::vector<unsigned int> Delta;
+  std::vector<std::vector<size_t> > Output;
+
+  // Entries whose literal was seen by the last Scan are marked with the
+  // current generation.
+  std::vector<unsigned int> Seen;
+  unsigned int Generation;
+};
+
+#endif
@@ -20,6 +20,8 @@
 #include <cm_zlib.h>
 #include <cmsys/Base64.h>
 
+#include <ctype.h>
+
 cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
 {
   this->CTest = handler->CTest;
@@ -381,12 +383,17 @@ bool cmCTestRunTest::NeedsToRerun()
 void cmCTestRunTest::ComputeWeightedCost()
 {
   double prev = static_cast<double>(this->TestProperties->PreviousRuns);
-  double avgcost = static_cast<double>(this->TestProperties->Cost);
+  double avgcost = this->TestProperties->AverageCost;
   double current = this->TestResult.ExecutionTime;
 
   if (this->TestResult.Status == cmCTestTestHandler::COMPLETED) {
-    this->TestProperties->Cost =
-      static_cast<float>(((prev * avgcost) + current) / (prev + 1.0));
+    // Update the running mean and variance (Welford's method).
+    double newavg = ((prev * avgcost) + current) / (prev + 1.0);
+    double m2 = this->TestProperties->CostVariance * prev +
+      (current - avgcost) * (current - newavg);
+    this->TestProperties->AverageCost = newavg;
+    this->TestProperties->CostVariance = m2 / (prev + 1.0);
+    this->TestProperties->Cost = static_cast<float>(newavg);
     this->TestProperties->PreviousRuns++;
   }
 }
@@ -489,8 +496,30 @@ bool cmCTestRunTest::StartTest(size_t total)
   if (this->StopTimePassed) {
     return false;
   }
+  std::vector<std::string> environment = this->TestProperties->Environment;
+  environment.insert(environment.end(), this->ResourcePoolEnvironment.begin(),
+                     this->ResourcePoolEnvironment.end());
   return this->ForkProcess(timeout, this->TestProperties->ExplicitTimeout,
-                           &this->TestProperties->Environment);
+                           &environment);
+}
+
+void cmCTestRunTest::SetResourcePoolSlots(
+  std::map<std::string, int> const& slots)
+{
+  this->ResourcePoolEnvironment.clear();
+  for (std::map<std::string, int>::const_iterator i = slots.begin();
+       i != slots.end(); ++i) {
+    // Make the pool name usable in an environment variable name.
+    std::string name = cmSystemTools::UpperCase(i->first);
+    for (std::string::iterator c = name.begin(); c != name.end(); ++c) {
+      if (!isalnum(static_cast<unsigned char>(*c))) {
+        *c = '_';
+      }
+    }
+    std::ostringstream var;
+    var << "CTEST_RESOURCE_POOL_" << name << "=" << i->second;
+    this->ResourcePoolEnvironment.push_back(var.str());
+  }
 }
 
 void cmCTestRunTest::ComputeArguments()
@@ -41,6 +41,9 @@ public:
 
   void SetIndex(int i) { this->Index = i; }
 
+  // Tell the test which slot of each resource pool it was given
+  void SetResourcePoolSlots(std::map<std::string, int> const& slots);
+
   int GetIndex() { return this->Index; }
 
   std::string GetProcessOutput() { return this->ProcessOutput; }
@@ -103,6 +106,7 @@ private:
   std::string StartTime;
   std::string ActualCommand;
   std::vector<std::string> Arguments;
+  std::vector<std::string> ResourcePoolEnvironment;
   bool StopTimePassed;
   bool RunUntilFail;
   int NumberOfRunsLeft;
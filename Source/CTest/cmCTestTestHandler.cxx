@@ -21,6 +21,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
+#include "cmTestManifest.h"
 #include "cmXMLWriter.h"
 #include "cm_utf8.h"
 #include "cmake.h"
@@ -939,6 +940,14 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<std::string>& passed,
     srand((unsigned)time(0));
   }
 
+  // Index the tests by name to resolve dependencies.  The first test
+  // with a given name wins.
+  cmCTestMultiProcessHandler::TestNameMap testIndices;
+  for (ListOfTests::iterator it = this->TestList.begin();
+       it != this->TestList.end(); ++it) {
+    testIndices.insert(std::make_pair(it->Name, it->Index));
+  }
+
   for (ListOfTests::iterator it = this->TestList.begin();
        it != this->TestList.end(); ++it) {
     cmCTestTestProperties& p = *it;
@@ -955,12 +964,10 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<std::string>& passed,
     if (!p.Depends.empty()) {
       for (std::vector<std::string>::iterator i = p.Depends.begin();
            i != p.Depends.end(); ++i) {
-        for (ListOfTests::iterator it2 = this->TestList.begin();
-             it2 != this->TestList.end(); ++it2) {
-          if (it2->Name == *i) {
-            depends.insert(it2->Index);
-            break; // break out of test loop as name can only match 1
-          }
+        cmCTestMultiProcessHandler::TestNameMap::const_iterator d =
+          testIndices.find(*i);
+        if (d != testIndices.end()) {
+          depends.insert(d->second);
         }
       }
     }
@@ -1346,6 +1353,22 @@ void cmCTestTestHandler::GetListOfTests()
   }
   cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                      "Constructing a list of tests" << std::endl, this->Quiet);
+
+  // Load the precompiled manifests if the whole tree has them.
+  std::string cwd = cmSystemTools::GetCurrentWorkingDirectory();
+  ListOfTests::size_type numTests = this->TestList.size();
+  bool loaded = this->ReadTestManifest(cwd);
+  cmSystemTools::ChangeDirectory(cwd);
+  if (loaded) {
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                       "Done constructing a list of tests from manifest"
+                         << std::endl,
+                       this->Quiet);
+    return;
+  }
+  this->TestList.erase(this->TestList.begin() + numTests,
+                       this->TestList.end());
+
   cmake cm;
   cm.SetHomeDirectory("");
   cm.SetHomeOutputDirectory("");
@@ -1398,6 +1421,108 @@ void cmCTestTestHandler::GetListOfTests()
                      this->Quiet);
 }
 
+bool cmCTestTestHandler::ReadTestManifest(std::string const& dir)
+{
+  std::string script = dir + "/CTestTestfile.cmake";
+  std::string manifest = dir + "/" + cmTestManifest::FileName();
+  int result;
+  if (!cmSystemTools::FileExists(manifest.c_str()) ||
+      !cmSystemTools::FileTimeCompare(script, manifest, &result) ||
+      result > 0) {
+    return false;
+  }
+  std::vector<cmTestManifest::Record> records;
+  if (!cmTestManifest::Read(manifest, records)) {
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                       "Ignoring invalid test manifest: " << manifest
+                                                          << std::endl,
+                       this->Quiet);
+    return false;
+  }
+  cmCTestOptionalLog(this->CTest, DEBUG,
+                     "Read test manifest: " << manifest << std::endl,
+                     this->Quiet);
+
+  // Tests take their working directory from the current directory.
+  cmSystemTools::ChangeDirectory(dir);
+
+  std::string const& config = this->CTest->GetConfigType();
+  for (std::vector<cmTestManifest::Record>::const_iterator ri =
+         records.begin() + 1;
+       ri != records.end(); ++ri) {
+    std::vector<std::string> const& fields = ri->Fields;
+    if (ri->Keyword == "test") {
+      // Fields: <mode> <nconfigs> <configs>... <nargs> <args>...
+      //         [<property> <value>]...
+      if (fields.size() < 2) {
+        return false;
+      }
+      size_t nconfigs = static_cast<size_t>(atoi(fields[1].c_str()));
+      size_t pos = 2 + nconfigs;
+      if (fields.size() <= pos) {
+        return false;
+      }
+      size_t nargs = static_cast<size_t>(atoi(fields[pos].c_str()));
+      ++pos;
+      if (nargs < 2 || fields.size() < pos + nargs) {
+        return false;
+      }
+      bool matched = false;
+      for (size_t i = 2; i < 2 + nconfigs; ++i) {
+        if (cmSystemTools::UpperCase(fields[i]) ==
+            cmSystemTools::UpperCase(config)) {
+          matched = true;
+          break;
+        }
+      }
+      if ((fields[0] == "=" && !matched) || (fields[0] == "!" && matched)) {
+        continue;
+      }
+      std::vector<std::string> args(fields.begin() + pos,
+                                    fields.begin() + pos + nargs);
+      if (!this->AddTest(args)) {
+        return false;
+      }
+      pos += nargs;
+      if (pos < fields.size()) {
+        std::vector<std::string> props;
+        props.push_back(args[0]);
+        props.push_back("PROPERTIES");
+        props.insert(props.end(), fields.begin() + pos, fields.end());
+        this->SetTestsProperties(props);
+      }
+    } else if (ri->Keyword == "subdir") {
+      if (fields.size() != 1) {
+        return false;
+      }
+      std::string subdir = fields[0];
+      if (!cmSystemTools::FileIsFullPath(subdir.c_str())) {
+        subdir = dir + "/" + subdir;
+      }
+      // Missing subdirectories or test files are ignored just as
+      // the subdirs() command in the script does.
+      if (!cmSystemTools::FileIsDirectory(subdir)) {
+        continue;
+      }
+      std::string subScript = subdir + "/CTestTestfile.cmake";
+      if (!cmSystemTools::FileExists(subScript.c_str())) {
+        std::string dartScript = subdir + "/DartTestfile.txt";
+        if (cmSystemTools::FileExists(dartScript.c_str())) {
+          return false;
+        }
+        continue;
+      }
+      if (!this->ReadTestManifest(subdir)) {
+        return false;
+      }
+      cmSystemTools::ChangeDirectory(dir);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
 void cmCTestTestHandler::UseIncludeRegExp()
 {
   this->UseIncludeRegExpFlag = true;
@@ -1823,6 +1948,22 @@ bool cmCTestTestHandler::SetTestsProperties(
 
             rtit->LockedResources.insert(lval.begin(), lval.end());
           }
+          if (key == "RESOURCE_POOL") {
+            std::vector<std::string> lval;
+            cmSystemTools::ExpandListArgument(val, lval);
+            for (std::vector<std::string>::iterator p = lval.begin();
+                 p != lval.end(); ++p) {
+              // Each entry is <name>[:<size>]
+              std::string name = *p;
+              int size = 1;
+              std::string::size_type pos = p->rfind(':');
+              if (pos != std::string::npos) {
+                name = p->substr(0, pos);
+                size = atoi(p->substr(pos + 1).c_str());
+              }
+              rtit->ResourcePools[name] = size < 1 ? 1 : size;
+            }
+          }
           if (key == "TIMEOUT") {
             rtit->Timeout = atof(val.c_str());
             rtit->ExplicitTimeout = true;
@@ -1978,6 +2119,8 @@ bool cmCTestTestHandler::AddTest(const std::vector<std::string>& args)
   test.Processors = 1;
   test.SkipReturnCode = -1;
   test.PreviousRuns = 0;
+  test.AverageCost = 0;
+  test.CostVariance = 0;
   if (this->UseIncludeRegExpFlag &&
       !this->IncludeTestsRegularExpression.find(testname.c_str())) {
     test.IsInBasedOnREOptions = false;
@@ -116,6 +116,9 @@ public:
     bool WillFail;
     float Cost;
     int PreviousRuns;
+    // Mean and variance of the execution time over the previous runs
+    double AverageCost;
+    double CostVariance;
     bool RunSerial;
     double Timeout;
     bool ExplicitTimeout;
@@ -128,6 +131,8 @@ public:
     std::vector<std::string> Environment;
     std::vector<std::string> Labels;
     std::set<std::string> LockedResources;
+    // Resource pools this test takes a slot from, with their sizes
+    std::map<std::string, int> ResourcePools;
   };
 
   struct cmCTestTestResult
@@ -232,6 +237,13 @@ private:
    * Get the list of tests in directory and subdirectories.
    */
   void GetListOfTests();
+
+  /**
+   * Load the tests of a directory and its subdirectories from the
+   * manifests written next to the test scripts.  Returns false if any
+   * directory has no usable manifest.
+   */
+  bool ReadTestManifest(std::string const& dir);
   // compute the lists of tests that will actually run
   // based on union regex and -I stuff
   void ComputeTestList();
@@ -55,6 +55,7 @@
 #include "cmTargetLinkLibrariesCommand.cxx"
 #include "cmTimestamp.cxx"
 #include "cmTryCompileCommand.cxx"
+#include "cmTryCompileWaitCommand.cxx"
 #include "cmTryRunCommand.cxx"
 #include "cmUnsetCommand.cxx"
 #include "cmWhileCommand.cxx"
@@ -97,6 +98,7 @@ void GetBootstrapCommands2(std::vector<cmCommand*>& commands)
   commands.push_back(new cmSubdirCommand);
   commands.push_back(new cmTargetLinkLibrariesCommand);
   commands.push_back(new cmTryCompileCommand);
+  commands.push_back(new cmTryCompileWaitCommand);
   commands.push_back(new cmTryRunCommand);
   commands.push_back(new cmUnsetCommand);
   commands.push_back(new cmWhileCommand);
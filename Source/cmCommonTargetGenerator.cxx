@@ -402,3 +402,58 @@ void cmCommonTargetGenerator::AppendOSXVerFlag(std::string& flags,
     this->LocalGenerator->AppendFlags(flags, vflag.str());
   }
 }
+
+std::string cmCommonTargetGenerator::CompileCommandMarker(
+  CompileCommandValue value)
+{
+  std::string marker(1, '\x1');
+  marker += static_cast<char>('0' + value);
+  return marker;
+}
+
+std::string const* cmCommonTargetGenerator::GetCompileCommandTemplate(
+  std::string const& lang, std::string const& flags,
+  std::string const& defines, std::string const& includes)
+{
+  std::map<std::string, CompileCommandTemplate>::const_iterator i =
+    this->CompileCommandTemplates.find(lang);
+  if (i == this->CompileCommandTemplates.end() || i->second.Flags != flags ||
+      i->second.Defines != defines || i->second.Includes != includes) {
+    return 0;
+  }
+  return &i->second.Command;
+}
+
+std::string const& cmCommonTargetGenerator::SetCompileCommandTemplate(
+  std::string const& lang, std::string const& flags,
+  std::string const& defines, std::string const& includes,
+  std::string const& command)
+{
+  CompileCommandTemplate& entry = this->CompileCommandTemplates[lang];
+  entry.Flags = flags;
+  entry.Defines = defines;
+  entry.Includes = includes;
+  entry.Command = cmGlobalGenerator::EscapeJSON(command);
+  return entry.Command;
+}
+
+std::string cmCommonTargetGenerator::ExpandCompileCommandTemplate(
+  std::string const& command,
+  std::string const (&values)[CompileCommandValueCount])
+{
+  std::string result;
+  result.reserve(command.size() + 256);
+  std::string::size_type pos = 0;
+  std::string::size_type marker;
+  while ((marker = command.find('\x1', pos)) != std::string::npos &&
+         marker + 1 < command.size()) {
+    result.append(command, pos, marker - pos);
+    int const value = command[marker + 1] - '0';
+    if (value >= 0 && value < CompileCommandValueCount) {
+      result += cmGlobalGenerator::EscapeJSON(values[value]);
+    }
+    pos = marker + 2;
+  }
+  result.append(command, pos, std::string::npos);
+  return result;
+}
@@ -90,6 +90,41 @@ protected:
   std::string GetManifests();
 
   std::vector<std::string> GetLinkedTargetDirectories() const;
+
+  // The compile commands exported to compile_commands.json differ between
+  // the sources of a target only in a few values.  The command of each
+  // language is escaped for JSON once, with markers in place of these
+  // values, and reused as long as the target-wide values match.
+  enum CompileCommandValue
+  {
+    CompileCommandSource,
+    CompileCommandObject,
+    CompileCommandObjectFileDir,
+    CompileCommandValueCount
+  };
+  static std::string CompileCommandMarker(CompileCommandValue value);
+  std::string const* GetCompileCommandTemplate(std::string const& lang,
+                                               std::string const& flags,
+                                               std::string const& defines,
+                                               std::string const& includes);
+  std::string const& SetCompileCommandTemplate(std::string const& lang,
+                                               std::string const& flags,
+                                               std::string const& defines,
+                                               std::string const& includes,
+                                               std::string const& command);
+  static std::string ExpandCompileCommandTemplate(
+    std::string const& command,
+    std::string const (&values)[CompileCommandValueCount]);
+
+private:
+  struct CompileCommandTemplate
+  {
+    std::string Flags;
+    std::string Defines;
+    std::string Includes;
+    std::string Command;
+  };
+  std::map<std::string, CompileCommandTemplate> CompileCommandTemplates;
 };
 
 #endif
@@ -14,6 +14,7 @@
 
 #include "cmAlgorithms.h"
 #include "cmOutputConverter.h"
+#include "cmRegularExpression.h"
 
 static std::string const keyAND = "AND";
 static std::string const keyCOMMAND = "COMMAND";
@@ -528,7 +529,7 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
         }
         const char* rex = argP2->c_str();
         this->Makefile.ClearMatches();
-        cmsys::RegularExpression regEntry;
+        cmRegularExpression regEntry;
         if (!regEntry.compile(rex)) {
           std::ostringstream error;
           error << "Regular expression \"" << rex << "\" cannot compile";
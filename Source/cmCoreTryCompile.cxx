@@ -12,11 +12,13 @@
 #include "cmCoreTryCompile.h"
 
 #include "cmAlgorithms.h"
+#include "cmCryptoHash.h"
 #include "cmExportTryCompileFileGenerator.h"
 #include "cmGlobalGenerator.h"
 #include "cmOutputConverter.h"
 #include "cmake.h"
 #include <cmsys/Directory.hxx>
+#include <cmsys/FStream.hxx>
 
 #include <assert.h>
 
@@ -49,6 +51,10 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
 {
   this->BinaryDirectory = argv[1].c_str();
   this->OutputFile = "";
+  this->Deferred = false;
+  this->CacheFile = "";
+  this->CacheEntry.clear();
+  this->CacheHit = false;
   // which signature were we called with ?
   this->SrcFileSignature = true;
 
@@ -86,11 +92,15 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   std::string copyFileError;
   std::vector<std::string> targets;
   std::string libsToLink = " ";
+  std::vector<std::string> linkLibraries;
   bool useOldLinkLibs = true;
   char targetNameBuf[64];
   bool didOutputVariable = false;
   bool didCopyFile = false;
   bool didCopyFileError = false;
+  bool defer = false;
+  std::vector<std::string> callback;
+  bool didCallback = false;
   bool useSources = argv[2] == "SOURCES";
   std::vector<std::string> sources;
 
@@ -123,12 +133,21 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     } else if (argv[i] == "COPY_FILE_ERROR") {
       doing = DoingCopyFileError;
       didCopyFileError = true;
+    } else if (argv[i] == "DEFER") {
+      doing = DoingNone;
+      defer = true;
+    } else if (argv[i] == "CALLBACK") {
+      // The callback takes all remaining arguments.
+      callback.assign(argv.begin() + i + 1, argv.end());
+      didCallback = true;
+      break;
     } else if (doing == DoingCMakeFlags) {
       cmakeFlags.push_back(argv[i]);
     } else if (doing == DoingCompileDefinitions) {
       compileDefs.push_back(argv[i]);
     } else if (doing == DoingLinkLibraries) {
       libsToLink += "\"" + cmSystemTools::TrimWhitespace(argv[i]) + "\" ";
+      linkLibraries.push_back(cmSystemTools::TrimWhitespace(argv[i]));
       if (cmTarget* tgt = this->Makefile->FindTargetToUse(argv[i])) {
         switch (tgt->GetType()) {
           case cmState::SHARED_LIBRARY:
@@ -203,6 +222,24 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     return -1;
   }
 
+  if (didCallback && callback.empty()) {
+    this->Makefile->IssueMessage(
+      cmake::FATAL_ERROR, "CALLBACK must be followed by a command name");
+    return -1;
+  }
+
+  if (didCallback && !defer) {
+    this->Makefile->IssueMessage(cmake::FATAL_ERROR,
+                                 "CALLBACK may be used only with DEFER");
+    return -1;
+  }
+
+  if (defer && isTryRun) {
+    this->Makefile->IssueMessage(cmake::FATAL_ERROR,
+                                 "DEFER may not be used with try_run");
+    return -1;
+  }
+
   if (useSources && sources.empty()) {
     this->Makefile->IssueMessage(
       cmake::FATAL_ERROR,
@@ -229,6 +266,11 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
         "COPY_FILE specified on a srcdir type TRY_COMPILE");
       return -1;
     }
+    if (defer) {
+      this->Makefile->IssueMessage(
+        cmake::FATAL_ERROR, "DEFER specified on a srcdir type TRY_COMPILE");
+      return -1;
+    }
   }
   // make sure the binary directory exists
   cmSystemTools::MakeDirectory(this->BinaryDirectory.c_str());
@@ -494,15 +536,78 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     }
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
+
+    // The result of a check whose output file is not kept may be shared
+    // through the result cache.
+    if (copyFile.empty() && targets.empty() && !defer) {
+      this->CacheFile =
+        this->ComputeCacheFile(outFileName, targetName, sources, testLangs,
+                               cmakeFlags, isTryRun);
+    }
   }
 
+  cmTryCompileQueue* queue =
+    this->Makefile->GetGlobalGenerator()->GetTryCompileQueue();
+  if (defer && sources.size() == 1 && targets.empty()) {
+    cmTryCompileQueue::Job job;
+    if (this->DeferTryCompile(sources[0], targetName, targetType, cmakeFlags,
+                              compileDefs, linkLibraries, useOldLinkLibs,
+                              job)) {
+      job.Makefile = this->Makefile;
+      job.Line = this->Makefile->GetExecutionContext().Line;
+      job.ResultVariable = argv[0];
+      job.OutputVariable = outputVariable;
+      job.CopyFile = copyFile;
+      job.CopyFileError = copyFileError;
+      job.Callback = callback;
+      queue->Submit(job);
+      this->Deferred = true;
+      return 0;
+    }
+  }
+
+  // A check run now must not overtake the checks queued before it.
+  queue->Wait();
+
   bool erroroc = cmSystemTools::GetErrorOccuredFlag();
   cmSystemTools::ResetErrorOccuredFlag();
   std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(
-    sourceDirectory, this->BinaryDirectory, projectName, targetName,
-    this->SrcFileSignature, &cmakeFlags, output);
+  int res = 0;
+  if (!this->CacheFile.empty() && this->ReadCacheEntry()) {
+    this->CacheHit = true;
+    res = this->CacheEntry["result"] == "0" ? 0 : 1;
+    output = "Using cached result from\n  " + this->CacheFile + "\n\n" +
+      this->CacheEntry["output"];
+  } else {
+    // build a single source directly if the project asked for it and the
+    // test project would need nothing more
+    bool direct = false;
+    if (this->SrcFileSignature && sources.size() == 1 && targets.empty() &&
+        this->Makefile->IsOn("CMAKE_TRY_COMPILE_DIRECT")) {
+      direct = this->TryCompileDirect(sources[0], targetName, targetType,
+                                      cmakeFlags, compileDefs, linkLibraries,
+                                      useOldLinkLibs, isTryRun, res, output);
+    }
+    // actually do the try compile now that everything is setup
+    if (!direct) {
+      res = this->Makefile->TryCompile(sourceDirectory, this->BinaryDirectory,
+                                       projectName, targetName,
+                                       this->SrcFileSignature, &cmakeFlags,
+                                       output);
+    }
+
+    // Do not share results of a build that reported an error.  The entry
+    // of try_run is written once the executable has run.
+    if (cmSystemTools::GetErrorOccuredFlag()) {
+      this->CacheFile = "";
+    } else if (!this->CacheFile.empty()) {
+      this->CacheEntry["result"] = res == 0 ? "0" : "1";
+      this->CacheEntry["output"] = output;
+      if (!isTryRun || res != 0) {
+        this->WriteCacheEntry();
+      }
+    }
+  }
   if (erroroc) {
     cmSystemTools::SetErrorOccured();
   }
@@ -518,7 +623,9 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
 
   if (this->SrcFileSignature) {
     std::string copyFileErrorMessage;
-    this->FindOutputFile(targetName, targetType);
+    if (!this->CacheHit) {
+      this->FindOutputFile(targetName, targetType);
+    }
 
     if ((res == 0) && !copyFile.empty()) {
       if (this->OutputFile.empty() ||
@@ -547,9 +654,610 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
                                     copyFileErrorMessage.c_str());
     }
   }
+
+  // A deferred check that could not be queued still reports its result.
+  if (!callback.empty()) {
+    cmTryCompileQueue::InvokeCallback(
+      this->Makefile, callback, this->Makefile->GetExecutionContext().Line);
+  }
   return res;
 }
 
+typedef std::map<std::string, std::vector<std::string> >
+  cmCoreTryCompileRuleValues;
+
+// The rule variables are written for the shell used by the Makefile and
+// Ninja generators.  Their commands can be run without a shell as long
+// as they are plain POSIX command lines.
+static bool cmCoreTryCompileDirectSupported(cmGlobalGenerator* gg)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  static_cast<void>(gg);
+  return false;
+#else
+  std::string const& name = gg->GetName();
+  return cmHasLiteralSuffix(name, "Unix Makefiles") ||
+    cmHasLiteralSuffix(name, "Ninja");
+#endif
+}
+
+// Append a flag taking a value.  A trailing space in the flag separates
+// it from the value.
+static void cmCoreTryCompileAppendFlag(std::vector<std::string>& args,
+                                       std::string const& flag,
+                                       std::string const& value)
+{
+  if (!flag.empty() && flag[flag.size() - 1] == ' ') {
+    args.push_back(cmSystemTools::TrimWhitespace(flag));
+    args.push_back(value);
+  } else {
+    args.push_back(flag + value);
+  }
+}
+
+static void cmCoreTryCompileAppendArgs(std::vector<std::string>& args,
+                                       std::string const& line)
+{
+  cmSystemTools::ParseUnixCommandLine(line.c_str(), args);
+}
+
+// Expand a rule variable such as CMAKE_C_COMPILE_OBJECT into commands.
+// A placeholder forming a whole argument may expand to any number of
+// arguments.  Returns false if the rule uses shell syntax or a
+// placeholder whose value is not known.
+static bool cmCoreTryCompileExpandRule(
+  std::string const& rule, cmCoreTryCompileRuleValues const& values,
+  std::vector<std::vector<std::string> >& commands)
+{
+  std::vector<std::string> lines;
+  cmSystemTools::ExpandListArgument(rule, lines);
+  for (std::vector<std::string>::const_iterator li = lines.begin();
+       li != lines.end(); ++li) {
+    std::vector<std::string> args;
+    cmCoreTryCompileAppendArgs(args, *li);
+    std::vector<std::string> command;
+    for (std::vector<std::string>::const_iterator ai = args.begin();
+         ai != args.end(); ++ai) {
+      std::string const& arg = *ai;
+      std::string expanded;
+      bool whole = false;
+      std::string::size_type pos = 0;
+      while (pos < arg.size()) {
+        std::string::size_type lt = arg.find('<', pos);
+        std::string literal = arg.substr(pos, lt - pos);
+        if (literal.find_first_of("&|;`$>") != std::string::npos) {
+          return false;
+        }
+        expanded += literal;
+        if (lt == std::string::npos) {
+          break;
+        }
+        std::string::size_type gt = arg.find('>', lt);
+        if (gt == std::string::npos) {
+          return false;
+        }
+        cmCoreTryCompileRuleValues::const_iterator vi =
+          values.find(arg.substr(lt + 1, gt - lt - 1));
+        if (vi == values.end()) {
+          return false;
+        }
+        if (lt == 0 && gt + 1 == arg.size()) {
+          command.insert(command.end(), vi->second.begin(), vi->second.end());
+          whole = true;
+        } else if (vi->second.size() > 1) {
+          return false;
+        } else if (!vi->second.empty()) {
+          expanded += vi->second[0];
+        }
+        pos = gt + 1;
+      }
+      if (!whole) {
+        command.push_back(expanded);
+      }
+    }
+    if (!command.empty()) {
+      commands.push_back(command);
+    }
+  }
+  return true;
+}
+
+bool cmCoreTryCompile::ComputeDirectCommands(
+  std::string const& source, std::string const& targetName,
+  cmState::TargetType targetType, std::vector<std::string> const& cmakeFlags,
+  std::vector<std::string> const& compileDefs,
+  std::vector<std::string> const& linkLibraries, bool useOldLinkLibs,
+  bool isTryRun, std::string const& outputDir,
+  std::vector<std::vector<std::string> >& commands, std::string& outputFile)
+{
+  cmMakefile* mf = this->Makefile;
+  cmGlobalGenerator* gg = mf->GetGlobalGenerator();
+  if (!cmCoreTryCompileDirectSupported(gg)) {
+    return false;
+  }
+  std::string const lang = gg->GetLanguageFromExtension(
+    cmSystemTools::GetFilenameLastExtension(source).c_str());
+  if (lang.empty()) {
+    return false;
+  }
+
+  // Interpret the cache entries the test project would be configured
+  // with.  Any other entry may change how the test project builds.
+  std::string compileDefinitions;
+  std::string exeLinkerFlags;
+  std::vector<std::string> includeDirs;
+  std::vector<std::string> linkDirs;
+  std::vector<std::string> libs;
+  if (!useOldLinkLibs) {
+    libs = linkLibraries;
+  }
+  for (std::vector<std::string>::const_iterator fi = cmakeFlags.begin() + 1;
+       fi != cmakeFlags.end(); ++fi) {
+    // Arguments that are not options are ignored by the test project.
+    if (fi->empty() || (*fi)[0] != '-') {
+      continue;
+    }
+    std::string var;
+    std::string value;
+    cmState::CacheEntryType type = cmState::UNINITIALIZED;
+    if (!cmHasLiteralPrefix(*fi, "-D") ||
+        !cmState::ParseCacheEntry(fi->substr(2), var, value, type)) {
+      return false;
+    }
+    if (var == "COMPILE_DEFINITIONS") {
+      compileDefinitions = value;
+    } else if (var == "EXE_LINKER_FLAGS") {
+      exeLinkerFlags = value;
+    } else if (var == "INCLUDE_DIRECTORIES") {
+      includeDirs.clear();
+      cmSystemTools::ExpandListArgument(value, includeDirs);
+    } else if (var == "LINK_DIRECTORIES") {
+      linkDirs.clear();
+      cmSystemTools::ExpandListArgument(value, linkDirs);
+    } else if (var == "LINK_LIBRARIES") {
+      if (useOldLinkLibs) {
+        libs.clear();
+        cmSystemTools::ExpandListArgument(value, libs);
+      }
+    } else if (var != "CMAKE_SKIP_RPATH") {
+      return false;
+    }
+  }
+
+  // An executable that is run needs runtime search paths for the
+  // libraries it links.  Leave computing those to the generators.
+  if (isTryRun && (!linkDirs.empty() || !libs.empty())) {
+    return false;
+  }
+
+  std::string const tcConfig = cmSystemTools::UpperCase(
+    mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION"));
+  std::string const langPrefix = "CMAKE_" + lang;
+  cmCoreTryCompileRuleValues values;
+
+  // Language flags, including the COMPILE_DEFINITIONS the test project
+  // appends to them.
+  std::string flags = mf->GetSafeDefinition(langPrefix + "_FLAGS");
+  flags += " ";
+  flags += compileDefinitions;
+  if (!tcConfig.empty()) {
+    flags += " ";
+    flags += mf->GetSafeDefinition(langPrefix + "_FLAGS_" + tcConfig);
+  }
+  cmCoreTryCompileAppendArgs(values["FLAGS"], flags);
+  cmCoreTryCompileAppendArgs(values["DEFINES"], cmJoin(compileDefs, " "));
+
+  std::vector<std::string>& includes = values["INCLUDES"];
+  if (!includeDirs.empty()) {
+    std::string const includeFlag =
+      mf->GetSafeDefinition("CMAKE_INCLUDE_FLAG_" + lang);
+    if (includeFlag.empty() ||
+        mf->GetDefinition("CMAKE_INCLUDE_FLAG_SEP_" + lang)) {
+      return false;
+    }
+    std::vector<std::string> implicitDirs;
+    cmSystemTools::ExpandListArgument(
+      mf->GetSafeDefinition(langPrefix + "_IMPLICIT_INCLUDE_DIRECTORIES"),
+      implicitDirs);
+    for (std::vector<std::string>::const_iterator ii = includeDirs.begin();
+         ii != includeDirs.end(); ++ii) {
+      std::string const dir =
+        cmSystemTools::CollapseFullPath(*ii, this->BinaryDirectory);
+      if (std::find(implicitDirs.begin(), implicitDirs.end(), dir) ==
+          implicitDirs.end()) {
+        cmCoreTryCompileAppendFlag(includes, includeFlag, dir);
+      }
+    }
+  }
+
+  std::vector<std::string>& linkLibs = values["LINK_LIBRARIES"];
+  std::string linkFlags;
+  std::string target = outputDir + "/";
+  if (targetType == cmState::EXECUTABLE) {
+    target += targetName;
+    target += mf->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
+
+    // The test project sets CMAKE_EXE_LINKER_FLAGS only if CMP0056 is NEW
+    // and otherwise initializes it like any other project.
+    if (mf->GetPolicyStatus(cmPolicies::CMP0056) == cmPolicies::NEW) {
+      linkFlags = mf->GetSafeDefinition("CMAKE_EXE_LINKER_FLAGS");
+    } else {
+      linkFlags = mf->GetSafeDefinition("CMAKE_EXE_LINKER_FLAGS_INIT");
+    }
+    linkFlags += " ";
+    linkFlags += exeLinkerFlags;
+    if (!tcConfig.empty()) {
+      linkFlags += " ";
+      linkFlags += mf->GetSafeDefinition("CMAKE_EXE_LINKER_FLAGS_" +
+                                         tcConfig + "_INIT");
+    }
+    linkFlags += " ";
+    linkFlags += mf->GetSafeDefinition("CMAKE_CREATE_CONSOLE_EXE");
+
+    if (mf->GetState()->GetGlobalPropertyAsBool(
+          "TARGET_SUPPORTS_SHARED_LIBS") &&
+        mf->GetPolicyStatus(cmPolicies::CMP0065) != cmPolicies::NEW) {
+      cmCoreTryCompileAppendArgs(
+        linkLibs,
+        mf->GetSafeDefinition("CMAKE_SHARED_LIBRARY_LINK_" + lang + "_FLAGS"));
+    }
+    std::string const libPathFlag =
+      mf->GetSafeDefinition("CMAKE_LIBRARY_PATH_FLAG");
+    std::string const libPathTerminator =
+      mf->GetSafeDefinition("CMAKE_LIBRARY_PATH_TERMINATOR");
+    for (std::vector<std::string>::const_iterator di = linkDirs.begin();
+         di != linkDirs.end(); ++di) {
+      cmCoreTryCompileAppendFlag(
+        linkLibs, libPathFlag,
+        cmSystemTools::CollapseFullPath(*di, this->BinaryDirectory) +
+          libPathTerminator);
+    }
+    std::string const libFlag =
+      mf->GetSafeDefinition("CMAKE_LINK_LIBRARY_FLAG");
+    std::string const libSuffix =
+      mf->GetSafeDefinition("CMAKE_LINK_LIBRARY_SUFFIX");
+    for (std::vector<std::string>::const_iterator li = libs.begin();
+         li != libs.end(); ++li) {
+      if (li->empty()) {
+        continue;
+      }
+      if ((*li)[0] == '-') {
+        cmCoreTryCompileAppendArgs(linkLibs, *li);
+      } else if (cmSystemTools::FileIsFullPath(*li)) {
+        linkLibs.push_back(*li);
+      } else if (li->find_first_of("./:") == std::string::npos &&
+                 *li != "debug" && *li != "optimized" && *li != "general" &&
+                 !mf->FindTargetToUse(*li)) {
+        cmCoreTryCompileAppendFlag(linkLibs, libFlag, *li + libSuffix);
+      } else {
+        // Let the generators resolve targets, library file names and
+        // configuration keywords.
+        return false;
+      }
+    }
+    cmCoreTryCompileAppendArgs(
+      linkLibs, mf->GetSafeDefinition(langPrefix + "_STANDARD_LIBRARIES"));
+  } else // if (targetType == cmState::STATIC_LIBRARY)
+  {
+    target += mf->GetSafeDefinition("CMAKE_STATIC_LIBRARY_PREFIX");
+    target += targetName;
+    target += mf->GetSafeDefinition("CMAKE_STATIC_LIBRARY_SUFFIX");
+
+    linkFlags = mf->GetSafeDefinition("CMAKE_STATIC_LINKER_FLAGS_INIT");
+    if (!tcConfig.empty()) {
+      linkFlags += " ";
+      linkFlags += mf->GetSafeDefinition("CMAKE_STATIC_LINKER_FLAGS_" +
+                                         tcConfig + "_INIT");
+    }
+  }
+  cmCoreTryCompileAppendArgs(values["LINK_FLAGS"], linkFlags);
+
+  // Name the object file the way the Makefile generator does.
+  std::string const objectDir =
+    outputDir + cmake::GetCMakeFilesDirectory() + "/" + targetName + ".dir";
+  std::string const sourcePath =
+    cmSystemTools::CollapseFullPath(source, this->BinaryDirectory);
+  std::string object = objectDir + "/";
+  if (mf->IsOn(langPrefix + "_OUTPUT_EXTENSION_REPLACE")) {
+    object += cmSystemTools::GetFilenameWithoutLastExtension(sourcePath);
+  } else {
+    object += cmSystemTools::GetFilenameName(sourcePath);
+  }
+  object += mf->GetSafeDefinition(langPrefix + "_OUTPUT_EXTENSION");
+
+  values["SOURCE"].push_back(sourcePath);
+  values["OBJECT"].push_back(object);
+  values["OBJECTS"].push_back(object);
+  values["OBJECT_DIR"].push_back(objectDir);
+  values["TARGET"].push_back(target);
+  values["LANGUAGE"].push_back(lang);
+  values["CMAKE_CURRENT_SOURCE_DIR"].push_back(this->BinaryDirectory);
+  values["CMAKE_CURRENT_BINARY_DIR"].push_back(this->BinaryDirectory);
+
+  // Tools named by the rules.  Like the generators, treat values that
+  // are not flags as paths.
+  std::vector<std::string>& compiler = values[langPrefix + "_COMPILER"];
+  compiler.push_back(mf->GetSafeDefinition(langPrefix + "_COMPILER"));
+  cmCoreTryCompileAppendArgs(
+    compiler, mf->GetSafeDefinition(langPrefix + "_COMPILER_ARG1"));
+  cmCoreTryCompileAppendArgs(
+    values[langPrefix + "_LINK_FLAGS"],
+    mf->GetSafeDefinition(langPrefix + "_LINK_FLAGS"));
+  static const char* const tools[] = { "_ARCHIVE", "CMAKE_AR", "CMAKE_RANLIB",
+                                       "CMAKE_LINKER", 0 };
+  for (const char* const* ti = tools; *ti; ++ti) {
+    std::string const var = **ti == '_' ? langPrefix + *ti : *ti;
+    std::string const tool = mf->GetSafeDefinition(var);
+    if (!tool.empty()) {
+      values[var].push_back(tool);
+    } else {
+      values[var];
+    }
+  }
+
+  // Expand all rules before running anything.
+  const char* compileRule =
+    mf->GetDefinition(langPrefix + "_COMPILE_OBJECT");
+  if (!compileRule ||
+      !cmCoreTryCompileExpandRule(compileRule, values, commands)) {
+    return false;
+  }
+  if (targetType == cmState::EXECUTABLE) {
+    const char* linkRule =
+      mf->GetDefinition(langPrefix + "_LINK_EXECUTABLE");
+    if (!linkRule ||
+        !cmCoreTryCompileExpandRule(linkRule, values, commands)) {
+      return false;
+    }
+  } else if (const char* createRule = mf->GetDefinition(
+               langPrefix + "_CREATE_STATIC_LIBRARY")) {
+    if (!cmCoreTryCompileExpandRule(createRule, values, commands)) {
+      return false;
+    }
+  } else {
+    const char* archiveRule =
+      mf->GetDefinition(langPrefix + "_ARCHIVE_CREATE");
+    const char* finishRule =
+      mf->GetDefinition(langPrefix + "_ARCHIVE_FINISH");
+    if (!archiveRule ||
+        !cmCoreTryCompileExpandRule(archiveRule, values, commands) ||
+        (finishRule &&
+         !cmCoreTryCompileExpandRule(finishRule, values, commands))) {
+      return false;
+    }
+  }
+
+  cmSystemTools::MakeDirectory(objectDir.c_str());
+  cmSystemTools::RemoveFile(target);
+  outputFile = target;
+  return true;
+}
+
+bool cmCoreTryCompile::TryCompileDirect(
+  std::string const& source, std::string const& targetName,
+  cmState::TargetType targetType, std::vector<std::string> const& cmakeFlags,
+  std::vector<std::string> const& compileDefs,
+  std::vector<std::string> const& linkLibraries, bool useOldLinkLibs,
+  bool isTryRun, int& res, std::string& output)
+{
+  std::vector<std::vector<std::string> > commands;
+  std::string outputFile;
+  if (!this->ComputeDirectCommands(source, targetName, targetType,
+                                   cmakeFlags, compileDefs, linkLibraries,
+                                   useOldLinkLibs, isTryRun,
+                                   this->BinaryDirectory, commands,
+                                   outputFile)) {
+    return false;
+  }
+
+  output = "Change Dir: ";
+  output += this->BinaryDirectory;
+  output += "\n";
+  res = 0;
+  for (std::vector<std::vector<std::string> >::const_iterator ci =
+         commands.begin();
+       ci != commands.end() && res == 0; ++ci) {
+    output += "\nRun Build Command:";
+    output += cmSystemTools::PrintSingleCommand(*ci);
+    output += "\n";
+    std::string commandOutput;
+    if (!cmSystemTools::RunSingleCommand(
+          *ci, &commandOutput, &commandOutput, &res,
+          this->BinaryDirectory.c_str(), cmSystemTools::OUTPUT_NONE)) {
+      res = 1;
+    }
+    output += commandOutput;
+  }
+  return true;
+}
+
+bool cmCoreTryCompile::DeferTryCompile(
+  std::string const& source, std::string const& targetName,
+  cmState::TargetType targetType, std::vector<std::string> const& cmakeFlags,
+  std::vector<std::string> const& compileDefs,
+  std::vector<std::string> const& linkLibraries, bool useOldLinkLibs,
+  cmTryCompileQueue::Job& job)
+{
+  // Each queued check builds in its own directory.  Give up on the rare
+  // clash of random target names instead of sharing one.
+  std::string const dir = this->BinaryDirectory + "/" + targetName;
+  if (cmSystemTools::FileExists(dir.c_str())) {
+    return false;
+  }
+  cmSystemTools::MakeDirectory(dir.c_str());
+
+  // Check modules write their sources to CMakeTmp and reuse the same
+  // name for the next check, so keep a copy until this one has run.
+  std::string src = source;
+  if (src.find("CMakeTmp") != src.npos) {
+    src = dir + "/" + cmSystemTools::GetFilenameName(source);
+    if (!cmSystemTools::CopyFileAlways(source, src)) {
+      cmSystemTools::RemoveADirectory(dir);
+      return false;
+    }
+  }
+
+  if (!this->ComputeDirectCommands(src, targetName, targetType, cmakeFlags,
+                                   compileDefs, linkLibraries, useOldLinkLibs,
+                                   false, dir, job.Commands,
+                                   job.OutputFile)) {
+    cmSystemTools::RemoveADirectory(dir);
+    return false;
+  }
+  job.Directory = dir;
+  return true;
+}
+
+static const char cmCoreTryCompileCacheHeader[] = "cmake-try-compile-cache 1";
+
+std::string cmCoreTryCompile::ComputeCacheFile(
+  std::string const& projectFile, std::string const& targetName,
+  std::vector<std::string> const& sources, std::set<std::string> const& langs,
+  std::vector<std::string> const& cmakeFlags, bool isTryRun)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmMakefile* mf = this->Makefile;
+  std::string const cacheDir =
+    mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CACHE_DIR");
+  if (cacheDir.empty()) {
+    return std::string();
+  }
+  std::string const emulator =
+    mf->GetSafeDefinition("CMAKE_CROSSCOMPILING_EMULATOR");
+  if (isTryRun && mf->IsOn("CMAKE_CROSSCOMPILING") && emulator.empty()) {
+    // The user provides the results of running.
+    return std::string();
+  }
+
+  cmsys::auto_ptr<cmCryptoHash> sha(cmCryptoHash::New("SHA256"));
+  std::ostringstream key;
+  key << "generator " << mf->GetGlobalGenerator()->GetName() << "\n";
+
+  // The test project names the sources, the scratch directory and the
+  // target, which differ between build trees and checks.
+  std::string project;
+  {
+    cmsys::ifstream fin(projectFile.c_str());
+    std::ostringstream content;
+    content << fin.rdbuf();
+    project = content.str();
+  }
+  for (std::vector<std::string>::const_iterator si = sources.begin();
+       si != sources.end(); ++si) {
+    std::string const hash = sha->HashFile(*si);
+    if (hash.empty()) {
+      return std::string();
+    }
+    key << "source " << cmSystemTools::GetFilenameLastExtension(*si) << " "
+        << hash << "\n";
+    cmSystemTools::ReplaceString(project, si->c_str(), "<SOURCE>");
+  }
+  cmSystemTools::ReplaceString(project, this->BinaryDirectory.c_str(),
+                               "<BINARY_DIR>");
+  cmSystemTools::ReplaceString(project, targetName.c_str(), "<TARGET>");
+  key << project;
+
+  for (std::vector<std::string>::const_iterator fi = cmakeFlags.begin() + 1;
+       fi != cmakeFlags.end(); ++fi) {
+    std::string flag = *fi;
+    cmSystemTools::ReplaceString(flag, this->BinaryDirectory.c_str(),
+                                 "<BINARY_DIR>");
+    key << "flag " << flag << "\n";
+  }
+
+  // Identify the compilers, including an upgrade in place.
+  for (std::set<std::string>::const_iterator li = langs.begin();
+       li != langs.end(); ++li) {
+    std::string const prefix = "CMAKE_" + *li + "_COMPILER";
+    std::string const compiler = mf->GetSafeDefinition(prefix);
+    key << "compiler " << *li << " " << compiler << " "
+        << cmSystemTools::ModifiedTime(compiler) << " "
+        << mf->GetSafeDefinition(prefix + "_ID") << " "
+        << mf->GetSafeDefinition(prefix + "_VERSION") << " "
+        << mf->GetSafeDefinition(prefix + "_ARG1") << "\n";
+  }
+  key << "config "
+      << mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION") << "\n";
+  if (isTryRun) {
+    key << "run " << emulator << " " << this->RunArgs << "\n";
+  }
+
+  return cacheDir + "/" + sha->HashString(key.str()) + ".txt";
+#else
+  static_cast<void>(projectFile);
+  static_cast<void>(targetName);
+  static_cast<void>(sources);
+  static_cast<void>(langs);
+  static_cast<void>(cmakeFlags);
+  static_cast<void>(isTryRun);
+  return std::string();
+#endif
+}
+
+bool cmCoreTryCompile::ReadCacheEntry()
+{
+  cmsys::ifstream fin(this->CacheFile.c_str(),
+                      std::ios::in | std::ios::binary);
+  std::string header;
+  if (!fin || !cmSystemTools::GetLineFromStream(fin, header) ||
+      header != cmCoreTryCompileCacheHeader) {
+    return false;
+  }
+
+  // Each field is its name and length on one line followed by its value
+  // and a newline.
+  std::map<std::string, std::string> entry;
+  std::string name;
+  while (fin >> name) {
+    size_t length = 0;
+    if (!(fin >> length) || fin.get() != '\n') {
+      return false;
+    }
+    std::string value(length, ' ');
+    if (length > 0 && !fin.read(&*value.begin(), length)) {
+      return false;
+    }
+    if (fin.get() != '\n') {
+      return false;
+    }
+    entry[name] = value;
+  }
+  if (entry.find("result") == entry.end()) {
+    return false;
+  }
+  this->CacheEntry.swap(entry);
+  return true;
+}
+
+void cmCoreTryCompile::WriteCacheEntry()
+{
+  // Write a temporary file and rename it so that configures sharing the
+  // cache never read a partial entry.
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(this->CacheFile).c_str());
+  char suffix[32];
+  sprintf(suffix, ".%08x.tmp", cmSystemTools::RandomSeed());
+  std::string const tmpFile = this->CacheFile + suffix;
+  bool written = false;
+  {
+    cmsys::ofstream fout(tmpFile.c_str(), std::ios::out | std::ios::binary);
+    if (fout) {
+      fout << cmCoreTryCompileCacheHeader << "\n";
+      for (std::map<std::string, std::string>::const_iterator ei =
+             this->CacheEntry.begin();
+           ei != this->CacheEntry.end(); ++ei) {
+        fout << ei->first << " " << ei->second.size() << "\n"
+             << ei->second << "\n";
+      }
+      written = !!fout;
+    }
+  }
+  if (!written ||
+      !cmSystemTools::RenameFile(tmpFile.c_str(), this->CacheFile.c_str())) {
+    cmSystemTools::RemoveFile(tmpFile);
+  }
+}
+
 void cmCoreTryCompile::CleanupFiles(const char* binDir)
 {
   if (!binDir) {
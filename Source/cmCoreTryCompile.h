@@ -13,6 +13,7 @@
 #define cmCoreTryCompile_h
 
 #include "cmCommand.h"
+#include "cmTryCompileQueue.h"
 
 /** \class cmCoreTryCompile
  * \brief Base class for cmTryCompileCommand and cmTryRunCommand
@@ -46,12 +47,88 @@ protected:
   void FindOutputFile(const std::string& targetName,
                       cmState::TargetType targetType);
 
+  /**
+   * Build a single source file by running the compile and link rules of
+   * the calling project directly instead of configuring, generating and
+   * building a test project.  Returns false without running anything if
+   * the test project needs more than the rule variables provide, in which
+   * case the caller must fall back to a full test project.  Otherwise the
+   * exit code of the failing command, or 0, is stored in res.
+   */
+  bool TryCompileDirect(std::string const& source,
+                        std::string const& targetName,
+                        cmState::TargetType targetType,
+                        std::vector<std::string> const& cmakeFlags,
+                        std::vector<std::string> const& compileDefs,
+                        std::vector<std::string> const& linkLibraries,
+                        bool useOldLinkLibs, bool isTryRun, int& res,
+                        std::string& output);
+
+  /**
+   * Compute the commands TryCompileDirect runs, placing the object file
+   * and the target in outputDir.
+   */
+  bool ComputeDirectCommands(std::string const& source,
+                             std::string const& targetName,
+                             cmState::TargetType targetType,
+                             std::vector<std::string> const& cmakeFlags,
+                             std::vector<std::string> const& compileDefs,
+                             std::vector<std::string> const& linkLibraries,
+                             bool useOldLinkLibs, bool isTryRun,
+                             std::string const& outputDir,
+                             std::vector<std::vector<std::string> >& commands,
+                             std::string& outputFile);
+
+  /**
+   * Prepare a check given the DEFER option to be run by the queue of the
+   * global generator.  The check gets a scratch directory of its own.
+   * Returns false if it cannot be run without a test project.
+   */
+  bool DeferTryCompile(std::string const& source,
+                       std::string const& targetName,
+                       cmState::TargetType targetType,
+                       std::vector<std::string> const& cmakeFlags,
+                       std::vector<std::string> const& compileDefs,
+                       std::vector<std::string> const& linkLibraries,
+                       bool useOldLinkLibs, cmTryCompileQueue::Job& job);
+
+  /**
+   * Name the entry of the result cache in CMAKE_TRY_COMPILE_CACHE_DIR
+   * that belongs to the test project just written.  The entry is named
+   * by a hash of everything the result depends on.  Returns an empty
+   * string if there is no cache or the project cannot be cached.
+   */
+  std::string ComputeCacheFile(std::string const& projectFile,
+                               std::string const& targetName,
+                               std::vector<std::string> const& sources,
+                               std::set<std::string> const& langs,
+                               std::vector<std::string> const& cmakeFlags,
+                               bool isTryRun);
+
+  /**
+   * Load the fields of the CacheFile entry into CacheEntry.  Returns
+   * false if there is no complete entry.
+   */
+  bool ReadCacheEntry();
+
+  /**
+   * Store the fields of CacheEntry in the CacheFile entry.
+   */
+  void WriteCacheEntry();
+
   cmTypeMacro(cmCoreTryCompile, cmCommand);
 
   std::string BinaryDirectory;
   std::string OutputFile;
   std::string FindErrorMessage;
   bool SrcFileSignature;
+  bool Deferred;
+
+  /** Arguments try_run passes to the executable, part of the cache key.  */
+  std::string RunArgs;
+  std::string CacheFile;
+  std::map<std::string, std::string> CacheEntry;
+  bool CacheHit;
 };
 
 #endif
@@ -11,10 +11,73 @@
 ============================================================================*/
 #include "cmDefinitions.h"
 
+#include "cmAlgorithms.h"
+#include "cmSystemTools.h"
+
 #include <assert.h>
 
 cmDefinitions::Def cmDefinitions::NoDef;
 
+bool cmDefinitions::Def::IsPlain(std::string const& value)
+{
+  return value.find_first_of("[]\\") == std::string::npos;
+}
+
+const char* cmDefinitions::Def::c_str() const
+{
+  if (!this->ValueValid) {
+    this->Value = cmJoin(this->List, ";");
+    this->ValueValid = true;
+  }
+  return this->Value.c_str();
+}
+
+std::vector<std::string> const& cmDefinitions::Def::GetList() const
+{
+  if (!this->ListValid) {
+    this->List.clear();
+    if (!this->Value.empty()) {
+      cmSystemTools::ExpandListArgument(this->Value, this->List, true);
+    }
+    this->ListValid = true;
+  }
+  return this->List;
+}
+
+void cmDefinitions::Def::Append(std::vector<std::string> const& values)
+{
+  if (values.empty()) {
+    return;
+  }
+  std::string const tail = cmJoin(values, ";");
+  if (!this->Plain || !IsPlain(tail)) {
+    // Brackets and escapes may join elements across the separator, so
+    // only the joined value is exact.
+    this->c_str();
+    if (!this->Value.empty()) {
+      this->Value += ";";
+    }
+    this->Value += tail;
+    this->ListValid = false;
+    this->Plain = false;
+    return;
+  }
+
+  // Without brackets and escapes every ';' separates two elements.
+  this->GetList();
+  std::vector<std::string>& list = this->List;
+  if (!list.empty() || !tail.empty()) {
+    std::string::size_type start = 0;
+    std::string::size_type pos;
+    while ((pos = tail.find(';', start)) != std::string::npos) {
+      list.push_back(tail.substr(start, pos - start));
+      start = pos + 1;
+    }
+    list.push_back(tail.substr(start));
+  }
+  this->ValueValid = false;
+}
+
 cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
                                                      StackIter begin,
                                                      StackIter end, bool raise)
@@ -44,6 +107,32 @@ const char* cmDefinitions::Get(const std::string& key, StackIter begin,
   return def.Exists ? def.c_str() : 0;
 }
 
+std::vector<std::string> const* cmDefinitions::GetList(
+  const std::string& key, StackIter begin, StackIter end)
+{
+  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
+  return def.Exists ? &def.GetList() : 0;
+}
+
+bool cmDefinitions::Append(const std::string& key,
+                           std::vector<std::string> const& values,
+                           StackIter begin, StackIter end)
+{
+  MapType::iterator i = begin->Map.find(key);
+  if (i == begin->Map.end()) {
+    Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
+    if (!def.Exists) {
+      return false;
+    }
+    i = begin->Map.insert(MapType::value_type(key, def)).first;
+  } else if (!i->second.Exists) {
+    return false;
+  }
+  i->second.Append(values);
+  i->second.Used = false;
+  return true;
+}
+
 void cmDefinitions::Raise(const std::string& key, StackIter begin,
                           StackIter end)
 {
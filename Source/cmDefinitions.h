@@ -45,6 +45,18 @@ public:
 
   static bool HasKey(const std::string& key, StackIter begin, StackIter end);
 
+  /** Get the elements of the list value of a key, or null if the key is
+      not set.  Empty elements are kept, but an empty value has none.  */
+  static std::vector<std::string> const* GetList(const std::string& key,
+                                                 StackIter begin,
+                                                 StackIter end);
+
+  /** Append elements to the list value of a key in the current scope, as
+      list(APPEND) does.  Returns false if the key is not set.  */
+  static bool Append(const std::string& key,
+                     std::vector<std::string> const& values, StackIter begin,
+                     StackIter end);
+
   /** Set (or unset if null) a value associated with a key.  */
   void Set(const std::string& key, const char* value);
 
@@ -55,39 +67,53 @@ public:
   static cmDefinitions MakeClosure(StackIter begin, StackIter end);
 
 private:
-  // String with existence boolean.
-  struct Def : public std::string
+  // String with existence boolean.  A value may also be held as its
+  // list elements, so that appending to a long list and reading it back
+  // do not re-join and re-split the whole value every time.  Each form
+  // is computed from the other when first needed.
+  struct Def
   {
-  private:
-    typedef std::string std_string;
-
-  public:
     Def()
-      : std_string()
-      , Exists(false)
+      : Exists(false)
       , Used(false)
+      , ValueValid(true)
+      , ListValid(false)
+      , Plain(true)
     {
     }
     Def(const char* v)
-      : std_string(v ? v : "")
-      , Exists(v ? true : false)
+      : Exists(v ? true : false)
       , Used(false)
+      , Value(v ? v : "")
+      , ValueValid(true)
+      , ListValid(false)
+      , Plain(IsPlain(this->Value))
     {
     }
-    Def(const std_string& v)
-      : std_string(v)
-      , Exists(true)
+    Def(const std::string& v)
+      : Exists(true)
       , Used(false)
+      , Value(v)
+      , ValueValid(true)
+      , ListValid(false)
+      , Plain(IsPlain(this->Value))
     {
     }
-    Def(Def const& d)
-      : std_string(d)
-      , Exists(d.Exists)
-      , Used(d.Used)
-    {
-    }
+    const char* c_str() const;
+    std::vector<std::string> const& GetList() const;
+    void Append(std::vector<std::string> const& values);
     bool Exists;
     bool Used;
+
+  private:
+    // Whether list elements can be found by splitting at every ';'.
+    static bool IsPlain(std::string const& value);
+
+    mutable std::string Value;
+    mutable std::vector<std::string> List;
+    mutable bool ValueValid;
+    mutable bool ListValid;
+    bool Plain;
   };
   static Def NoDef;
 
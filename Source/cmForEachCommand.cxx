@@ -203,9 +203,13 @@ bool cmForEachCommand::HandleInMode(std::vector<std::string> const& args)
     } else if (args[i] == "ITEMS") {
       doing = DoingItems;
     } else if (doing == DoingLists) {
-      const char* value = this->Makefile->GetDefinition(args[i]);
-      if (value && *value) {
-        cmSystemTools::ExpandListArgument(value, f->Args, true);
+      if (std::vector<std::string> const* elements =
+            this->Makefile->GetDefinitionList(args[i])) {
+        f->Args.insert(f->Args.end(), elements->begin(), elements->end());
+      } else if (const char* value = this->Makefile->GetDefinition(args[i])) {
+        if (*value) {
+          cmSystemTools::ExpandListArgument(value, f->Args, true);
+        }
       }
     } else {
       std::ostringstream e;
@@ -95,6 +95,16 @@ void cmGeneratedFileStream::SetCompressionExtraExtension(bool ext)
   this->CompressExtraExtension = ext;
 }
 
+static cmGeneratedFileStream::CloseCallback cmGeneratedFileStreamCloseCallback;
+static void* cmGeneratedFileStreamCloseCallbackClientData;
+
+void cmGeneratedFileStream::SetCloseCallback(CloseCallback f,
+                                             void* clientData)
+{
+  cmGeneratedFileStreamCloseCallback = f;
+  cmGeneratedFileStreamCloseCallbackClientData = clientData;
+}
+
 cmGeneratedFileStreamBase::cmGeneratedFileStreamBase()
   : Name()
   , TempName()
@@ -150,6 +160,15 @@ bool cmGeneratedFileStreamBase::Close()
     resname += ".gz";
   }
 
+  // Note the size of the output before the temporary file goes away.
+  // The destructor closes again after an explicit Close, but then the
+  // temporary file no longer exists and nothing is reported.
+  bool const report = cmGeneratedFileStreamCloseCallback &&
+    !this->Name.empty() && this->Okay &&
+    cmSystemTools::FileExists(this->TempName.c_str(), true);
+  unsigned long const bytes =
+    report ? cmSystemTools::FileLength(this->TempName) : 0;
+
   // Only consider replacing the destination file if no error
   // occurred.
   if (!this->Name.empty() && this->Okay &&
@@ -175,6 +194,11 @@ bool cmGeneratedFileStreamBase::Close()
   // Always delete the temporary file. We never want it to stay around.
   cmSystemTools::RemoveFile(this->TempName);
 
+  if (report) {
+    (*cmGeneratedFileStreamCloseCallback)(
+      resname, bytes, replaced, cmGeneratedFileStreamCloseCallbackClientData);
+  }
+
   return replaced;
 }
 
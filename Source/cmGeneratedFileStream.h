@@ -139,6 +139,15 @@ public:
    */
   void SetName(const std::string& fname);
 
+  /**
+   * Set a function to be told about every generated file when it is
+   * closed: its name, the number of bytes written and whether the
+   * file on disk was replaced.  Pass 0 to stop.
+   */
+  typedef void (*CloseCallback)(const std::string& name, unsigned long bytes,
+                                bool replaced, void* clientData);
+  static void SetCloseCallback(CloseCallback f, void* clientData = 0);
+
 private:
   cmGeneratedFileStream(cmGeneratedFileStream const&); // not implemented
 };
@@ -19,6 +19,7 @@
 #include "cmGeneratorExpressionEvaluator.h"
 #include "cmGeneratorExpressionLexer.h"
 #include "cmGeneratorExpressionParser.h"
+#include "cmGeneratorTarget.h"
 
 cmGeneratorExpression::cmGeneratorExpression(
   const cmListFileBacktrace& backtrace)
@@ -74,6 +75,11 @@ const char* cmCompiledGeneratorExpression::EvaluateWithContext(
     return this->Input.c_str();
   }
 
+  if (cmGeneratorTarget const* target =
+        context.HeadTarget ? context.HeadTarget : context.CurrentTarget) {
+    target->AddGeneratorExpressionEvaluation();
+  }
+
   this->Output = "";
 
   std::vector<cmGeneratorExpressionEvaluator*>::const_iterator it =
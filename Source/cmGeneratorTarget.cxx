@@ -267,6 +267,7 @@ cmGeneratorTarget::cmGeneratorTarget(cmTarget* t, cmLocalGenerator* lg)
   , DebugSourcesDone(false)
   , LinkImplementationLanguageIsContextDependent(true)
   , UtilityItemsDone(false)
+  , GeneratorExpressionEvaluations(0)
 {
   this->Makefile = this->Target->GetMakefile();
   this->LocalGenerator = lg;
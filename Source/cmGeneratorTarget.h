@@ -526,6 +526,18 @@ public:
   void GetTargetVersion(bool soversion, int& major, int& minor,
                         int& patch) const;
 
+  /** Count an evaluation of a generator expression for this target.  */
+  void AddGeneratorExpressionEvaluation() const
+  {
+    ++this->GeneratorExpressionEvaluations;
+  }
+
+  /** Number of generator expressions evaluated for this target.  */
+  unsigned long GetGeneratorExpressionEvaluations() const
+  {
+    return this->GeneratorExpressionEvaluations;
+  }
+
 private:
   friend class cmTargetTraceDependencies;
   struct SourceEntry
@@ -696,6 +708,7 @@ private:
   mutable bool DebugSourcesDone;
   mutable bool LinkImplementationLanguageIsContextDependent;
   mutable bool UtilityItemsDone;
+  mutable unsigned long GeneratorExpressionEvaluations;
   bool DLLPlatform;
 
   bool ComputePDBOutputDir(const std::string& kind, const std::string& config,
@@ -33,6 +33,7 @@
 #include "cmSourceFile.h"
 #include "cmState.h"
 #include "cmTargetExport.h"
+#include "cmTryCompileQueue.h"
 #include "cmVersion.h"
 #include "cmake.h"
 
@@ -40,6 +41,7 @@
 #include <cmsys/FStream.hxx>
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
+#include "cmMakefileProfilingData.h"
 #include "cm_jsoncpp_value.h"
 #include "cm_jsoncpp_writer.h"
 #include <cmsys/MD5.h>
@@ -84,6 +86,7 @@ cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
   this->ExtraGenerator = 0;
   this->CurrentMakefile = 0;
   this->TryCompileOuterMakefile = 0;
+  this->TryCompileQueue = new cmTryCompileQueue;
 
   this->ConfigureDoneCMP0026AndCMP0024 = false;
 
@@ -99,6 +102,7 @@ cmGlobalGenerator::~cmGlobalGenerator()
 {
   this->ClearGeneratorMembers();
   delete this->ExtraGenerator;
+  delete this->TryCompileQueue;
 }
 
 bool cmGlobalGenerator::SetGeneratorPlatform(std::string const& p,
@@ -1095,6 +1099,11 @@ void cmGlobalGenerator::Configure()
       msg << "Configuring done";
     }
     this->CMakeInstance->UpdateProgress(msg.str().c_str(), -1);
+    if (this->CMakeInstance->GetMemoryStats()) {
+      std::ostringstream stats;
+      this->CMakeInstance->GetState()->PrintStorageStatistics(stats);
+      cmSystemTools::Stdout(stats.str().c_str());
+    }
   }
 }
 
@@ -1182,7 +1191,19 @@ bool cmGlobalGenerator::Compute()
   if (!this->CheckALLOW_DUPLICATE_CUSTOM_TARGETS()) {
     return false;
   }
-  this->FinalizeTargetCompileInfo();
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmMakefileProfilingData* profiling =
+    this->CMakeInstance->GetProfilingOutput();
+#endif
+
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::Scope profilingScope(
+      profiling, "cmake.generate", "FinalizeTargetCompileInfo");
+#endif
+    this->FinalizeTargetCompileInfo();
+  }
 
   this->CreateGenerationObjects();
 
@@ -1237,8 +1258,14 @@ bool cmGlobalGenerator::Compute()
   }
 
   // Compute the inter-target dependencies.
-  if (!this->ComputeTargetDepends()) {
-    return false;
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::Scope profilingScope(
+      profiling, "cmake.generate", "ComputeTargetDepends");
+#endif
+    if (!this->ComputeTargetDepends()) {
+      return false;
+    }
   }
 
   for (i = 0; i < this->LocalGenerators.size(); ++i) {
@@ -1256,8 +1283,18 @@ void cmGlobalGenerator::Generate()
 
   this->ProcessEvaluationFiles();
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmMakefileProfilingData* profiling =
+    this->CMakeInstance->GetProfilingOutput();
+#endif
+
   // Generate project files
   for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::Scope profilingScope(
+      profiling, "cmake.generate",
+      this->LocalGenerators[i]->GetCurrentBinaryDirectory());
+#endif
     this->SetCurrentMakefile(this->LocalGenerators[i]->GetMakefile());
     this->LocalGenerators[i]->Generate();
     if (!this->LocalGenerators[i]->GetMakefile()->IsOn(
@@ -1287,7 +1324,13 @@ void cmGlobalGenerator::Generate()
     }
   }
   // Update rule hashes.
-  this->CheckRuleHashes();
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::Scope profilingScope(profiling, "cmake.generate",
+                                                  "CheckRuleHashes");
+#endif
+    this->CheckRuleHashes();
+  }
 
   this->WriteSummary();
 
@@ -1499,6 +1542,9 @@ void cmGlobalGenerator::ClearGeneratorMembers()
   cmDeleteAll(this->BuildExportSets);
   this->BuildExportSets.clear();
 
+  // Deferred checks refer to the makefiles.
+  *this->TryCompileQueue = cmTryCompileQueue();
+
   cmDeleteAll(this->Makefiles);
   this->Makefiles.clear();
 
@@ -2735,6 +2781,7 @@ void cmGlobalGenerator::WriteSummary(cmGeneratorTarget* target)
 std::string cmGlobalGenerator::EscapeJSON(const std::string& s)
 {
   std::string result;
+  result.reserve(s.size());
   for (std::string::size_type i = 0; i < s.size(); ++i) {
     if (s[i] == '"' || s[i] == '\\') {
       result += '\\';
@@ -2744,6 +2791,45 @@ std::string cmGlobalGenerator::EscapeJSON(const std::string& s)
   return result;
 }
 
+// static
+void cmGlobalGenerator::WriteCompileCommand(std::ostream& os,
+                                            const std::string& directory,
+                                            const std::string& escapedCommand,
+                                            const std::string& file,
+                                            bool arguments)
+{
+  os << "{\n"
+     << "  \"directory\": \"" << EscapeJSON(directory) << "\",\n";
+  if (arguments) {
+    std::string command;
+    command.reserve(escapedCommand.size());
+    for (std::string::size_type i = 0; i < escapedCommand.size(); ++i) {
+      if (escapedCommand[i] == '\\' && i + 1 < escapedCommand.size()) {
+        ++i;
+      }
+      command += escapedCommand[i];
+    }
+    std::vector<std::string> args;
+#if defined(_WIN32)
+    cmSystemTools::ParseWindowsCommandLine(command.c_str(), args);
+#else
+    cmSystemTools::ParseUnixCommandLine(command.c_str(), args);
+#endif
+    os << "  \"arguments\": [";
+    const char* sep = "";
+    for (std::vector<std::string>::const_iterator ai = args.begin();
+         ai != args.end(); ++ai) {
+      os << sep << "\"" << EscapeJSON(*ai) << "\"";
+      sep = ", ";
+    }
+    os << "],\n";
+  } else {
+    os << "  \"command\": \"" << escapedCommand << "\",\n";
+  }
+  os << "  \"file\": \"" << EscapeJSON(file) << "\"\n"
+     << "}";
+}
+
 void cmGlobalGenerator::SetFilenameTargetDepends(
   cmSourceFile* sf, std::set<cmGeneratorTarget const*> const& tgts)
 {
@@ -41,6 +41,7 @@ class cmTarget;
 class cmInstallTargetGenerator;
 class cmInstallFilesGenerator;
 class cmExportBuildFileGenerator;
+class cmTryCompileQueue;
 
 /** \class cmGlobalGenerator
  * \brief Responsible for overseeing the generation process for the entire tree
@@ -207,6 +208,12 @@ public:
 
   int TryCompileTimeout;
 
+  /** Checks deferred by try_compile until they are waited for.  */
+  cmTryCompileQueue* GetTryCompileQueue() const
+  {
+    return this->TryCompileQueue;
+  }
+
   bool GetForceUnixPaths() const { return this->ForceUnixPaths; }
   bool GetToolSupportsColor() const { return this->ToolSupportsColor; }
 
@@ -328,6 +335,14 @@ public:
 
   static std::string EscapeJSON(const std::string& s);
 
+  /** Write an entry of compile_commands.json.  The command is given
+      already escaped by EscapeJSON.  If @a arguments is true it is
+      written as an array of its arguments instead of a string.  */
+  static void WriteCompileCommand(std::ostream& os,
+                                  const std::string& directory,
+                                  const std::string& escapedCommand,
+                                  const std::string& file, bool arguments);
+
   void ProcessEvaluationFiles();
 
   std::map<std::string, cmExportBuildFileGenerator*>& GetBuildExportSets()
@@ -452,6 +467,7 @@ private:
   GeneratorTargetMap GeneratorTargetSearchIndex;
 
   cmMakefile* TryCompileOuterMakefile;
+  cmTryCompileQueue* TryCompileQueue;
   // If you add a new map here, make sure it is copied
   // in EnableLanguagesFromGenerator
   std::map<std::string, bool> IgnoreExtensions;
@@ -246,7 +246,7 @@ void cmGlobalNinjaGenerator::AddCustomCommandRule()
 }
 
 void cmGlobalNinjaGenerator::WriteCustomCommandBuild(
-  const std::string& command, const std::string& description,
+  std::ostream& os, const std::string& command, const std::string& description,
   const std::string& comment, bool uses_terminal, bool restat,
   const cmNinjaDeps& outputs, const cmNinjaDeps& deps,
   const cmNinjaDeps& orderOnly)
@@ -270,8 +270,8 @@ void cmGlobalNinjaGenerator::WriteCustomCommandBuild(
     vars["pool"] = "console";
   }
 
-  this->WriteBuild(*this->BuildFileStream, comment, "CUSTOM_COMMAND", outputs,
-                   deps, cmNinjaDeps(), orderOnly, vars);
+  this->WriteBuild(os, comment, "CUSTOM_COMMAND", outputs, deps,
+                   cmNinjaDeps(), orderOnly, vars);
 
   if (this->ComputingUnknownDependencies) {
     // we need to track every dependency that comes in, since we are trying
@@ -423,6 +423,14 @@ void cmGlobalNinjaGenerator::WriteInclude(std::ostream& os,
   os << "include " << filename << "\n";
 }
 
+void cmGlobalNinjaGenerator::WriteSubninja(std::ostream& os,
+                                           const std::string& filename,
+                                           const std::string& comment)
+{
+  cmGlobalNinjaGenerator::WriteComment(os, comment);
+  os << "subninja " << filename << "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteDefault(std::ostream& os,
                                           const cmNinjaDeps& targets,
                                           const std::string& comment)
@@ -440,6 +448,7 @@ cmGlobalNinjaGenerator::cmGlobalNinjaGenerator(cmake* cm)
   , BuildFileStream(0)
   , RulesFileStream(0)
   , CompileCommandsStream(0)
+  , CompileCommandsArguments(false)
   , Rules()
   , AllDependencies()
   , UsingGCCOnWindows(false)
@@ -760,7 +769,7 @@ std::string cmGlobalNinjaGenerator::ConvertToNinjaFolderRule(
 }
 
 void cmGlobalNinjaGenerator::AddCXXCompileCommand(
-  const std::string& commandLine, const std::string& sourceFile)
+  const std::string& escapedCommandLine, const std::string& sourceFile)
 {
   // Compute Ninja's build file path.
   std::string buildFileDir =
@@ -772,6 +781,9 @@ void cmGlobalNinjaGenerator::AddCXXCompileCommand(
     this->CompileCommandsStream =
       new cmGeneratedFileStream(buildFilePath.c_str());
     *this->CompileCommandsStream << "[";
+    this->CompileCommandsArguments =
+      this->LocalGenerators[0]->GetMakefile()->IsOn(
+        "CMAKE_EXPORT_COMPILE_COMMANDS_ARGUMENTS");
   } else {
     *this->CompileCommandsStream << "," << std::endl;
   }
@@ -782,16 +794,10 @@ void cmGlobalNinjaGenerator::AddCXXCompileCommand(
       sourceFileName, this->GetCMakeInstance()->GetHomeOutputDirectory());
   }
 
-  /* clang-format off */
-  *this->CompileCommandsStream << "\n{\n"
-     << "  \"directory\": \""
-     << cmGlobalGenerator::EscapeJSON(buildFileDir) << "\",\n"
-     << "  \"command\": \""
-     << cmGlobalGenerator::EscapeJSON(commandLine) << "\",\n"
-     << "  \"file\": \""
-     << cmGlobalGenerator::EscapeJSON(sourceFileName) << "\"\n"
-     << "}";
-  /* clang-format on */
+  *this->CompileCommandsStream << "\n";
+  cmGlobalGenerator::WriteCompileCommand(
+    *this->CompileCommandsStream, buildFileDir, escapedCommandLine,
+    sourceFileName, this->CompileCommandsArguments);
 }
 
 void cmGlobalNinjaGenerator::CloseCompileCommandsStream()
@@ -828,7 +834,8 @@ void cmGlobalNinjaGenerator::WriteAssumedSourceDependencies()
        i != this->AssumedSourceDependencies.end(); ++i) {
     cmNinjaDeps deps;
     std::copy(i->second.begin(), i->second.end(), std::back_inserter(deps));
-    WriteCustomCommandBuild(/*command=*/"", /*description=*/"",
+    WriteCustomCommandBuild(*this->BuildFileStream, /*command=*/"",
+                            /*description=*/"",
                             "Assume dependencies for generated source file.",
                             /*uses_terminal*/ false,
                             /*restat*/ true, cmNinjaDeps(1, i->first), deps);
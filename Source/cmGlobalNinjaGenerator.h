@@ -105,7 +105,7 @@ public:
                        const cmNinjaDeps& orderOnlyDeps = cmNinjaDeps(),
                        const cmNinjaVars& variables = cmNinjaVars());
 
-  void WriteCustomCommandBuild(const std::string& command,
+  void WriteCustomCommandBuild(std::ostream& os, const std::string& command,
                                const std::string& description,
                                const std::string& comment, bool uses_terminal,
                                bool restat, const cmNinjaDeps& outputs,
@@ -144,6 +144,13 @@ public:
   static void WriteInclude(std::ostream& os, const std::string& filename,
                            const std::string& comment = "");
 
+  /**
+   * Write a subninja statement including @a filename in its own scope
+   * with an optional @a comment to the @a os stream.
+   */
+  static void WriteSubninja(std::ostream& os, const std::string& filename,
+                            const std::string& comment = "");
+
   /**
    * Write a default target statement specifying @a targets as
    * the default targets.
@@ -235,7 +242,9 @@ public:
   };
   MapToNinjaPathImpl MapToNinjaPath() { return MapToNinjaPathImpl(this); }
 
-  void AddCXXCompileCommand(const std::string& commandLine,
+  /// Add an entry to compile_commands.json.  The command line is given
+  /// already escaped by EscapeJSON.
+  void AddCXXCompileCommand(const std::string& escapedCommandLine,
                             const std::string& sourceFile);
 
   /**
@@ -359,6 +368,7 @@ private:
   /// edge of the compilation DAG).
   cmGeneratedFileStream* RulesFileStream;
   cmGeneratedFileStream* CompileCommandsStream;
+  bool CompileCommandsArguments;
 
   /// The type used to store the set of rules added to the generated build
   /// system.
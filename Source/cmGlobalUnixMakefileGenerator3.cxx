@@ -33,6 +33,7 @@ cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3(cmake* cm)
   this->UseLinkScript = true;
 #endif
   this->CommandDatabase = NULL;
+  this->CommandDatabaseArguments = false;
 
   this->IncludeDirective = "include";
   this->DefineWindowsNULL = false;
@@ -164,7 +165,7 @@ void cmGlobalUnixMakefileGenerator3::Generate()
 
 void cmGlobalUnixMakefileGenerator3::AddCXXCompileCommand(
   const std::string& sourceFile, const std::string& workingDirectory,
-  const std::string& compileCommand)
+  const std::string& escapedCompileCommand)
 {
   if (this->CommandDatabase == NULL) {
     std::string commandDatabaseName =
@@ -173,20 +174,15 @@ void cmGlobalUnixMakefileGenerator3::AddCXXCompileCommand(
     this->CommandDatabase =
       new cmGeneratedFileStream(commandDatabaseName.c_str());
     *this->CommandDatabase << "[" << std::endl;
+    this->CommandDatabaseArguments =
+      this->LocalGenerators[0]->GetMakefile()->IsOn(
+        "CMAKE_EXPORT_COMPILE_COMMANDS_ARGUMENTS");
   } else {
     *this->CommandDatabase << "," << std::endl;
   }
-  *this->CommandDatabase << "{" << std::endl
-                         << "  \"directory\": \""
-                         << cmGlobalGenerator::EscapeJSON(workingDirectory)
-                         << "\"," << std::endl
-                         << "  \"command\": \""
-                         << cmGlobalGenerator::EscapeJSON(compileCommand)
-                         << "\"," << std::endl
-                         << "  \"file\": \""
-                         << cmGlobalGenerator::EscapeJSON(sourceFile) << "\""
-                         << std::endl
-                         << "}";
+  cmGlobalGenerator::WriteCompileCommand(
+    *this->CommandDatabase, workingDirectory, escapedCompileCommand,
+    sourceFile, this->CommandDatabaseArguments);
 }
 
 void cmGlobalUnixMakefileGenerator3::WriteMainMakefile2()
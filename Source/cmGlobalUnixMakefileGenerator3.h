@@ -126,9 +126,11 @@ public:
   /** Record per-target progress information.  */
   void RecordTargetProgress(cmMakefileTargetGenerator* tg);
 
+  /** Add an entry to compile_commands.json.  The compile command is
+      given already escaped by EscapeJSON.  */
   void AddCXXCompileCommand(const std::string& sourceFile,
                             const std::string& workingDirectory,
-                            const std::string& compileCommand);
+                            const std::string& escapedCompileCommand);
 
   /** Does the make tool tolerate .NOTPARALLEL? */
   virtual bool AllowNotParallel() const { return true; }
@@ -212,6 +214,7 @@ protected:
   size_t CountProgressMarksInAll(cmLocalGenerator* lg);
 
   cmGeneratedFileStream* CommandDatabase;
+  bool CommandDatabaseArguments;
 
 private:
   virtual const char* GetBuildIgnoreErrorsFlag() const { return "-i"; }
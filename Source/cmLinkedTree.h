@@ -15,6 +15,7 @@
 #include "cmStandardIncludes.h"
 
 #include <assert.h>
+#include <deque>
 
 /**
   @brief A adaptor for traversing a tree structure in a vector
@@ -30,12 +31,13 @@
 
   An iterator resulting from this tree construction can be
   forward-only-iterated toward the root.  Extending the tree never
-  invalidates existing iterators.
+  invalidates existing iterators, and never moves or copies the
+  existing entries, so references to them also stay valid.
  */
 template <typename T>
 class cmLinkedTree
 {
-  typedef typename std::vector<T>::size_type PositionType;
+  typedef typename std::deque<T>::size_type PositionType;
   typedef T* PointerType;
   typedef T& ReferenceType;
 
@@ -144,7 +146,7 @@ public:
 
   iterator Push(iterator it) { return Push_impl(it, T()); }
 
-  iterator Push(iterator it, T t) { return Push_impl(it, t); }
+  iterator Push(iterator it, T const& t) { return Push_impl(it, t); }
 
   bool IsLast(iterator it) { return it.Position == this->Data.size(); }
 
@@ -179,12 +181,14 @@ public:
     this->Data.clear();
   }
 
+  size_t Size() const { return this->Data.size(); }
+
 private:
   T& GetReference(PositionType pos) { return this->Data[pos]; }
 
   T* GetPointer(PositionType pos) { return &this->Data[pos]; }
 
-  iterator Push_impl(iterator it, T t)
+  iterator Push_impl(iterator it, T const& t)
   {
     assert(this->UpPositions.size() == this->Data.size());
     assert(it.Position <= this->UpPositions.size());
@@ -193,7 +197,7 @@ private:
     return iterator(this, this->UpPositions.size());
   }
 
-  std::vector<T> Data;
+  std::deque<T> Data;
   std::vector<PositionType> UpPositions;
 };
 
@@ -12,7 +12,8 @@
 #include "cmListCommand.h"
 
 #include "cmAlgorithms.h"
-#include <cmsys/RegularExpression.hxx>
+#include "cmRegularExpression.h"
+
 #include <cmsys/SystemTools.hxx>
 
 #include <algorithm>
@@ -81,6 +82,36 @@ bool cmListCommand::GetListString(std::string& listString,
 
 bool cmListCommand::GetList(std::vector<std::string>& list,
                             const std::string& var)
+{
+  std::vector<std::string> const* elements =
+    this->GetListElements(list, var);
+  if (!elements) {
+    return false;
+  }
+  if (elements != &list) {
+    list.insert(list.end(), elements->begin(), elements->end());
+  }
+  return true;
+}
+
+std::vector<std::string> const* cmListCommand::GetListElements(
+  std::vector<std::string>& storage, const std::string& var)
+{
+  // use the elements of a normal variable without splitting it again
+  std::vector<std::string> const* elements =
+    this->Makefile->GetDefinitionList(var);
+  if (elements &&
+      (std::find(elements->begin(), elements->end(), std::string()) ==
+         elements->end() ||
+       this->Makefile->GetPolicyStatus(cmPolicies::CMP0007) ==
+         cmPolicies::NEW)) {
+    return elements;
+  }
+  return this->GetListFromString(storage, var) ? &storage : 0;
+}
+
+bool cmListCommand::GetListFromString(std::vector<std::string>& list,
+                                      const std::string& var)
 {
   std::string listString;
   if (!this->GetListString(listString, var)) {
@@ -141,11 +172,10 @@ bool cmListCommand::HandleLengthCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   std::vector<std::string> varArgsExpanded;
-  // do not check the return value here
-  // if the list var is not found varArgsExpanded will have size 0
-  // and we will return 0
-  this->GetList(varArgsExpanded, listName);
-  size_t length = varArgsExpanded.size();
+  // if the list var is not found we will return 0
+  std::vector<std::string> const* elements =
+    this->GetListElements(varArgsExpanded, listName);
+  size_t length = elements ? elements->size() : 0;
   char buffer[1024];
   sprintf(buffer, "%d", static_cast<int>(length));
 
@@ -163,11 +193,14 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  std::vector<std::string> varArgsStorage;
+  std::vector<std::string> const* elements =
+    this->GetListElements(varArgsStorage, listName);
+  if (!elements) {
     this->Makefile->AddDefinition(variableName, "NOTFOUND");
     return true;
   }
+  std::vector<std::string> const& varArgsExpanded = *elements;
   // FIXME: Add policy to make non-existing lists an error like empty lists.
   if (varArgsExpanded.empty()) {
     this->SetError("GET given empty list");
@@ -209,16 +242,8 @@ bool cmListCommand::HandleAppendCommand(std::vector<std::string> const& args)
   }
 
   const std::string& listName = args[1];
-  // expand the variable
-  std::string listString;
-  this->GetListString(listString, listName);
-
-  if (!listString.empty() && !args.empty()) {
-    listString += ";";
-  }
-  listString += cmJoin(cmMakeRange(args).advance(2), ";");
-
-  this->Makefile->AddDefinition(listName, listString.c_str());
+  std::vector<std::string> const values(args.begin() + 2, args.end());
+  this->Makefile->AppendDefinition(listName, values);
   return true;
 }
 
@@ -503,7 +528,7 @@ bool cmListCommand::HandleFilterCommand(std::vector<std::string> const& args)
 class MatchesRegex
 {
 public:
-  MatchesRegex(cmsys::RegularExpression& in_regex, bool in_includeMatches)
+  MatchesRegex(cmRegularExpression& in_regex, bool in_includeMatches)
     : regex(in_regex)
     , includeMatches(in_includeMatches)
   {
@@ -515,7 +540,7 @@ public:
   }
 
 private:
-  cmsys::RegularExpression& regex;
+  cmRegularExpression& regex;
   const bool includeMatches;
 };
 
@@ -525,7 +550,7 @@ bool cmListCommand::FilterRegex(std::vector<std::string> const& args,
                                 std::vector<std::string>& varArgsExpanded)
 {
   const std::string& pattern = args[4];
-  cmsys::RegularExpression regex(pattern);
+  cmRegularExpression regex(pattern);
   if (!regex.is_valid()) {
     std::string error = "sub-command FILTER, mode REGEX ";
     error += "failed to compile regex \"";
@@ -18,6 +18,9 @@
 #include "cmVersion.h"
 
 #include <cmsys/RegularExpression.hxx>
+#include <cmsys/hash_set.hxx>
+
+#include <new>
 
 struct cmListFileParser
 {
@@ -332,10 +335,31 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
   }
 }
 
-struct cmListFileBacktrace::Entry : public cmListFileContext
+// Backtrace entries refer to file paths and command names through a
+// table of unique strings so that pushing one allocates no strings.
+static std::string const* cmListFileBacktraceIntern(std::string const& s)
+{
+  static cmsys::hash_set<std::string> strings;
+  return &*strings.insert(s).first;
+}
+
+// Most entries are pushed from the same file as the entry below them.
+static std::string const* cmListFileBacktraceInternPath(
+  std::string const& s, std::string const* below)
+{
+  if (below && *below == s) {
+    return below;
+  }
+  return cmListFileBacktraceIntern(s);
+}
+
+struct cmListFileBacktrace::Entry
 {
-  Entry(cmListFileContext const& lfc, Entry* up)
-    : cmListFileContext(lfc)
+  Entry(std::string const* name, std::string const* filePath, long line,
+        Entry* up)
+    : Name(name)
+    , FilePath(filePath)
+    , Line(line)
     , Up(up)
     , RefCount(0)
   {
@@ -356,14 +380,81 @@ struct cmListFileBacktrace::Entry : public cmListFileContext
       delete this;
     }
   }
+  cmListFileContext GetContext() const
+  {
+    cmListFileContext lfc;
+    lfc.Name = *this->Name;
+    lfc.FilePath = *this->FilePath;
+    lfc.Line = this->Line;
+    return lfc;
+  }
+  std::string const* Name;
+  std::string const* FilePath;
+  long Line;
   Entry* Up;
   unsigned int RefCount;
+
+  // An entry is pushed and popped for every command invocation, so
+  // entries are recycled through a free list.
+  static void* operator new(size_t size);
+  static void operator delete(void* p);
+  static void* FreeList;
+  static void* Blocks;
 };
 
+void* cmListFileBacktrace::Entry::FreeList = 0;
+void* cmListFileBacktrace::Entry::Blocks = 0;
+
+void* cmListFileBacktrace::Entry::operator new(size_t size)
+{
+  assert(size == sizeof(Entry));
+  static_cast<void>(size);
+  if (!FreeList) {
+    // Allocate a block whose first slot links it to the previous block
+    // and put the other slots on the free list.
+    size_t const count = 256;
+    char* block = static_cast<char*>(malloc(count * sizeof(Entry)));
+    if (!block) {
+      throw std::bad_alloc();
+    }
+    *reinterpret_cast<void**>(block) = Blocks;
+    Blocks = block;
+    for (size_t i = 1; i < count; ++i) {
+      void* slot = block + i * sizeof(Entry);
+      *static_cast<void**>(slot) = FreeList;
+      FreeList = slot;
+    }
+  }
+  void* p = FreeList;
+  FreeList = *static_cast<void**>(p);
+  return p;
+}
+
+void cmListFileBacktrace::Entry::operator delete(void* p)
+{
+  *static_cast<void**>(p) = FreeList;
+  FreeList = p;
+}
+
 cmListFileBacktrace::cmListFileBacktrace(cmState::Snapshot bottom, Entry* up,
                                          cmListFileContext const& lfc)
   : Bottom(bottom)
-  , Cur(new Entry(lfc, up))
+  , Cur(new Entry(
+      cmListFileBacktraceIntern(lfc.Name),
+      cmListFileBacktraceInternPath(lfc.FilePath, up ? up->FilePath : 0),
+      lfc.Line, up))
+{
+  assert(this->Bottom.IsValid());
+  this->Cur->Ref();
+}
+
+cmListFileBacktrace::cmListFileBacktrace(cmState::Snapshot bottom, Entry* up,
+                                         cmCommandContext const& cc,
+                                         std::string const& file)
+  : Bottom(bottom)
+  , Cur(new Entry(cmListFileBacktraceIntern(cc.Name),
+                  cmListFileBacktraceInternPath(file, up ? up->FilePath : 0),
+                  cc.Line, up))
 {
   assert(this->Bottom.IsValid());
   this->Cur->Ref();
@@ -423,9 +514,8 @@ cmListFileBacktrace cmListFileBacktrace::Push(std::string const& file) const
   // any specific line or command invocation within it.  This context
   // is useful to print when it is at the top but otherwise can be
   // skipped during call stack printing.
-  cmListFileContext lfc;
-  lfc.FilePath = file;
-  return cmListFileBacktrace(this->Bottom, this->Cur, lfc);
+  return cmListFileBacktrace(this->Bottom, this->Cur, cmCommandContext(),
+                             file);
 }
 
 cmListFileBacktrace cmListFileBacktrace::Push(
@@ -434,19 +524,24 @@ cmListFileBacktrace cmListFileBacktrace::Push(
   return cmListFileBacktrace(this->Bottom, this->Cur, lfc);
 }
 
+cmListFileBacktrace cmListFileBacktrace::Push(cmCommandContext const& cc,
+                                              std::string const& file) const
+{
+  return cmListFileBacktrace(this->Bottom, this->Cur, cc, file);
+}
+
 cmListFileBacktrace cmListFileBacktrace::Pop() const
 {
   assert(this->Cur);
   return cmListFileBacktrace(this->Bottom, this->Cur->Up);
 }
 
-cmListFileContext const& cmListFileBacktrace::Top() const
+cmListFileContext cmListFileBacktrace::Top() const
 {
   if (this->Cur) {
-    return *this->Cur;
+    return this->Cur->GetContext();
   } else {
-    static cmListFileContext const empty;
-    return empty;
+    return cmListFileContext();
   }
 }
 
@@ -456,7 +551,7 @@ void cmListFileBacktrace::PrintTitle(std::ostream& out) const
     return;
   }
   cmOutputConverter converter(this->Bottom);
-  cmListFileContext lfc = *this->Cur;
+  cmListFileContext lfc = this->Cur->GetContext();
   if (!this->Bottom.GetState()->GetIsInTryCompile()) {
     lfc.FilePath = converter.Convert(lfc.FilePath, cmOutputConverter::HOME);
   }
@@ -472,7 +567,7 @@ void cmListFileBacktrace::PrintCallStack(std::ostream& out) const
   bool first = true;
   cmOutputConverter converter(this->Bottom);
   for (Entry* i = this->Cur->Up; i; i = i->Up) {
-    if (i->Name.empty()) {
+    if (i->Name->empty()) {
       // Skip this whole-file scope.  When we get here we already will
       // have printed a more-specific context within the file.
       continue;
@@ -481,7 +576,7 @@ void cmListFileBacktrace::PrintCallStack(std::ostream& out) const
       first = false;
       out << "Call Stack (most recent call first):\n";
     }
-    cmListFileContext lfc = *i;
+    cmListFileContext lfc = i->GetContext();
     if (!this->Bottom.GetState()->GetIsInTryCompile()) {
       lfc.FilePath = converter.Convert(lfc.FilePath, cmOutputConverter::HOME);
     }
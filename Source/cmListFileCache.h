@@ -132,6 +132,8 @@ public:
   // Get a backtrace with the given call context added to the top.
   // May not be called until after construction with a valid snapshot.
   cmListFileBacktrace Push(cmListFileContext const& lfc) const;
+  cmListFileBacktrace Push(cmCommandContext const& cc,
+                           std::string const& file) const;
 
   // Get a backtrace with the top level removed.
   // May not be called until after a matching Push.
@@ -139,7 +141,7 @@ public:
 
   // Get the context at the top of the backtrace.
   // Returns an empty context if the backtrace is empty.
-  cmListFileContext const& Top() const;
+  cmListFileContext Top() const;
 
   // Print the top of the backtrace.
   void PrintTitle(std::ostream& out) const;
@@ -153,6 +155,8 @@ private:
   Entry* Cur;
   cmListFileBacktrace(cmState::Snapshot bottom, Entry* up,
                       cmListFileContext const& lfc);
+  cmListFileBacktrace(cmState::Snapshot bottom, Entry* up,
+                      cmCommandContext const& cc, std::string const& file);
   cmListFileBacktrace(cmState::Snapshot bottom, Entry* cur);
 };
 
@@ -25,6 +25,7 @@
 #include "cmSourceFile.h"
 #include "cmTest.h"
 #include "cmTestGenerator.h"
+#include "cmTestManifest.h"
 #include "cmVersion.h"
 #include "cmake.h"
 
@@ -160,6 +161,15 @@ void cmLocalGenerator::GenerateTestFiles()
     fout << "include(\"" << testIncludeFile << "\")" << std::endl;
   }
 
+  // Write a manifest with the same content that ctest can load without
+  // evaluating the script.  It is not possible if the script includes
+  // arbitrary user code.
+  std::ostringstream manifest;
+  bool haveManifest = !testIncludeFile;
+  if (haveManifest) {
+    cmTestManifest::WriteHeader(manifest);
+  }
+
   // Ask each test generator to write its code.
   std::vector<cmTestGenerator*> const& testers =
     this->Makefile->GetTestGenerators();
@@ -167,6 +177,10 @@ void cmLocalGenerator::GenerateTestFiles()
        gi != testers.end(); ++gi) {
     (*gi)->Compute(this);
     (*gi)->Generate(fout, config, configurationTypes);
+    if (haveManifest) {
+      haveManifest =
+        (*gi)->GenerateManifest(manifest, config, configurationTypes);
+    }
   }
   size_t i;
   std::vector<cmState::Snapshot> children =
@@ -175,8 +189,29 @@ void cmLocalGenerator::GenerateTestFiles()
     // TODO: Use add_subdirectory instead?
     fout << "subdirs(";
     std::string outP = children[i].GetDirectory().GetCurrentBinary();
-    fout << this->Convert(outP, START_OUTPUT);
+    std::string relP = this->Convert(outP, START_OUTPUT);
+    fout << relP;
     fout << ")" << std::endl;
+    if (haveManifest) {
+      cmTestManifest::WriteRecord(manifest, "subdir",
+                                  std::vector<std::string>(1, relP));
+    }
+  }
+
+  fout.Close();
+
+  // The manifest is always rewritten so that it is never older than the
+  // script.  ctest falls back to the script otherwise.
+  std::string manifestFile =
+    this->StateSnapshot.GetDirectory().GetCurrentBinary();
+  manifestFile += "/";
+  manifestFile += cmTestManifest::FileName();
+  if (haveManifest) {
+    cmGeneratedFileStream mout;
+    mout.Open(manifestFile.c_str(), false, true);
+    mout << manifest.str();
+  } else {
+    cmSystemTools::RemoveFile(manifestFile);
   }
 }
 
@@ -27,6 +27,7 @@ cmLocalNinjaGenerator::cmLocalNinjaGenerator(cmGlobalGenerator* gg,
                                              cmMakefile* mf)
   : cmLocalCommonGenerator(gg, mf)
   , HomeRelativeOutputPath("")
+  , SubninjaFileStream(0)
 {
   this->TargetImplib = "$TARGET_IMPLIB";
 }
@@ -49,6 +50,11 @@ void cmLocalNinjaGenerator::Generate()
 
   this->SetConfigName();
 
+  if (!this->IsRootMakefile() &&
+      this->Makefile->IsOn("CMAKE_NINJA_SUBNINJA_FILES")) {
+    this->OpenSubninjaFileStream();
+  }
+
   this->WriteProcessedMakefile(this->GetBuildFileStream());
 #ifdef NINJA_GEN_VERBOSE_FILES
   this->WriteProcessedMakefile(this->GetRulesFileStream());
@@ -88,6 +94,8 @@ void cmLocalNinjaGenerator::Generate()
   }
 
   this->WriteCustomCommandBuildStatements();
+
+  this->CloseSubninjaFileStream();
 }
 
 // TODO: Picked up from cmLocalUnixMakefileGenerator3.  Refactor it.
@@ -140,9 +148,42 @@ std::string cmLocalNinjaGenerator::ConvertToIncludeReference(
 
 cmGeneratedFileStream& cmLocalNinjaGenerator::GetBuildFileStream() const
 {
+  if (this->SubninjaFileStream) {
+    return *this->SubninjaFileStream;
+  }
   return *this->GetGlobalNinjaGenerator()->GetBuildFileStream();
 }
 
+void cmLocalNinjaGenerator::OpenSubninjaFileStream()
+{
+  // The build statements of this directory go to a file of its own that
+  // the main build file reads with a subninja statement.  Ninja parses it
+  // in a scope of its own, so the variables written for its targets do
+  // not add to the scope of the main build file.
+  std::string buildFilePath = this->GetCurrentBinaryDirectory();
+  buildFilePath += cmake::GetCMakeFilesDirectory();
+  buildFilePath += "/";
+  buildFilePath += cmGlobalNinjaGenerator::NINJA_BUILD_FILE;
+
+  this->SubninjaFileStream = new cmGeneratedFileStream(buildFilePath.c_str());
+
+  cmGlobalNinjaGenerator* ng = this->GetGlobalNinjaGenerator();
+  std::ostream& os = *ng->GetBuildFileStream();
+  std::string const subninjaPath =
+    ng->EncodeIdent(ng->EncodePath(ng->ConvertToNinjaPath(buildFilePath)), os);
+  cmGlobalNinjaGenerator::WriteSubninja(
+    os, subninjaPath, "Build statements of directory " +
+      this->Convert(this->GetCurrentBinaryDirectory(),
+                    cmOutputConverter::HOME_OUTPUT));
+  os << "\n";
+}
+
+void cmLocalNinjaGenerator::CloseSubninjaFileStream()
+{
+  delete this->SubninjaFileStream;
+  this->SubninjaFileStream = 0;
+}
+
 cmGeneratedFileStream& cmLocalNinjaGenerator::GetRulesFileStream() const
 {
   return *this->GetGlobalNinjaGenerator()->GetRulesFileStream();
@@ -404,8 +445,9 @@ void cmLocalNinjaGenerator::WriteCustomCommandBuildStatement(
       cmNinjaDeps(), orderOnlyDeps, cmNinjaVars());
   } else {
     this->GetGlobalNinjaGenerator()->WriteCustomCommandBuild(
-      this->BuildCommandLine(cmdLines), this->ConstructComment(ccg),
-      "Custom command for " + ninjaOutputs[0], cc->GetUsesTerminal(),
+      this->GetBuildFileStream(), this->BuildCommandLine(cmdLines),
+      this->ConstructComment(ccg), "Custom command for " + ninjaOutputs[0],
+      cc->GetUsesTerminal(),
       /*restat*/ !symbolic || !byproducts.empty(), ninjaOutputs, ninjaDeps,
       orderOnlyDeps);
   }
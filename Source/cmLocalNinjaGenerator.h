@@ -80,6 +80,10 @@ public:
     std::map<cmSourceFile const*, std::string>& mapping,
     cmGeneratorTarget const* gt = 0);
 
+  /// @returns the stream the build statements of this directory are
+  /// written to.
+  cmGeneratedFileStream& GetBuildFileStream() const;
+
 protected:
   virtual std::string ConvertToIncludeReference(
     std::string const& path,
@@ -87,9 +91,11 @@ protected:
     bool forceFullPaths = false);
 
 private:
-  cmGeneratedFileStream& GetBuildFileStream() const;
   cmGeneratedFileStream& GetRulesFileStream() const;
 
+  void OpenSubninjaFileStream();
+  void CloseSubninjaFileStream();
+
   void WriteBuildFileTop();
   void WriteProjectHeader(std::ostream& os);
   void WriteNinjaRequiredVersion(std::ostream& os);
@@ -106,6 +112,7 @@ private:
   std::string MakeCustomLauncher(cmCustomCommandGenerator const& ccg);
 
   std::string HomeRelativeOutputPath;
+  cmGeneratedFileStream* SubninjaFileStream;
 
   typedef std::map<cmCustomCommand const*, std::set<cmGeneratorTarget*> >
     CustomCommandTargetMap;
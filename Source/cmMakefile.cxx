@@ -20,6 +20,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmListFileCache.h"
 #include "cmOutputConverter.h"
+#include "cmRegularExpression.h"
 #include "cmSourceFile.h"
 #include "cmSourceFileLocation.h"
 #include "cmState.h"
@@ -27,11 +28,13 @@
 #include "cmTest.h"
 #include "cmVersion.h"
 #ifdef CMAKE_BUILD_WITH_CMAKE
+#include "cmMakefileProfilingData.h"
 #include "cmVariableWatch.h"
 #endif
 #include "cmAlgorithms.h"
 #include "cmInstallGenerator.h"
 #include "cmTestGenerator.h"
+#include "cmTryCompileQueue.h"
 #include "cmake.h"
 #include <stdlib.h> // required for atoi
 
@@ -156,19 +159,12 @@ cmListFileBacktrace cmMakefile::GetBacktrace() const
 
 cmListFileBacktrace cmMakefile::GetBacktrace(cmCommandContext const& cc) const
 {
-  cmListFileContext lfc;
-  lfc.Name = cc.Name;
-  lfc.Line = cc.Line;
-  lfc.FilePath = this->StateSnapshot.GetExecutionListFile();
-  return this->Backtrace.Push(lfc);
+  return this->Backtrace.Push(cc, this->StateSnapshot.GetExecutionListFile());
 }
 
 cmListFileContext cmMakefile::GetExecutionContext() const
 {
-  cmListFileContext const& cur = this->Backtrace.Top();
-  cmListFileContext lfc;
-  lfc.Name = cur.Name;
-  lfc.Line = cur.Line;
+  cmListFileContext lfc = this->Backtrace.Top();
   lfc.FilePath = this->StateSnapshot.GetExecutionListFile();
   return lfc;
 }
@@ -204,9 +200,8 @@ public:
                  cmExecutionStatus& status)
     : Makefile(mf)
   {
-    cmListFileContext const& lfc = cmListFileContext::FromCommandContext(
+    this->Makefile->Backtrace = this->Makefile->Backtrace.Push(
       cc, this->Makefile->StateSnapshot.GetExecutionListFile());
-    this->Makefile->Backtrace = this->Makefile->Backtrace.Push(lfc);
     this->Makefile->ExecutionStatusStack.push_back(&status);
   }
 
@@ -253,9 +248,21 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
       if (this->GetCMakeInstance()->GetTrace()) {
         this->PrintCommandTrace(lff);
       }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+      cmMakefileProfilingData* profiling =
+        this->GetCMakeInstance()->GetProfilingOutput();
+      if (profiling) {
+        profiling->StartEntry(lff, this->GetExecutionContext());
+      }
+#endif
       // Try invoking the command.
-      if (!pcmd->InvokeInitialPass(lff.Arguments, status) ||
-          status.GetNestedError()) {
+      bool invokeSucceeded = pcmd->InvokeInitialPass(lff.Arguments, status);
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+      if (profiling) {
+        profiling->StopEntry();
+      }
+#endif
+      if (!invokeSucceeded || status.GetNestedError()) {
         if (!status.GetNestedError()) {
           // The command invocation requested that we report an error.
           this->IssueMessage(cmake::FATAL_ERROR, pcmd->GetError());
@@ -504,6 +511,14 @@ void cmMakefile::ReadListFile(cmListFile const& listFile,
   this->MarkVariableAsUsed("CMAKE_CURRENT_LIST_FILE");
   this->MarkVariableAsUsed("CMAKE_CURRENT_LIST_DIR");
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmMakefileProfilingData* profiling =
+    this->GetCMakeInstance()->GetProfilingOutput();
+  if (profiling) {
+    profiling->StartEntry("cmake.listfile", filenametoread);
+  }
+#endif
+
   // Run the parsed commands.
   const size_t numberFunctions = listFile.Functions.size();
   for (size_t i = 0; i < numberFunctions; ++i) {
@@ -517,6 +532,11 @@ void cmMakefile::ReadListFile(cmListFile const& listFile,
       break;
     }
   }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (profiling) {
+    profiling->StopEntry();
+  }
+#endif
   this->CheckForUnusedVariables();
 
   this->AddDefinition("CMAKE_PARENT_LIST_FILE", currentParentFile.c_str());
@@ -1425,6 +1445,11 @@ void cmMakefile::Configure()
     return;
   }
   this->ReadListFile(listFile, currentStart);
+
+  // Store the results of checks the directory deferred but never waited
+  // for.
+  this->GetGlobalGenerator()->GetTryCompileQueue()->Wait();
+
   if (cmSystemTools::GetFatalErrorOccured()) {
     scope.Quiet();
   }
@@ -1683,6 +1708,35 @@ void cmMakefile::MarkVariableAsUsed(const std::string& var)
   this->StateSnapshot.GetDefinition(var);
 }
 
+void cmMakefile::AppendDefinition(const std::string& name,
+                                  std::vector<std::string> const& values)
+{
+  if (!this->IsDefinitionWatched(name) &&
+      this->StateSnapshot.AppendDefinition(name, values)) {
+    this->LogUnused("changing definition", name);
+    return;
+  }
+
+  // Cache entries and watched variables go through the string value.
+  std::string value = this->GetSafeDefinition(name);
+  if (!value.empty() && !values.empty()) {
+    value += ";";
+  }
+  value += cmJoin(values, ";");
+  this->AddDefinition(name, value.c_str());
+}
+
+bool cmMakefile::IsDefinitionWatched(const std::string& name) const
+{
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  cmVariableWatch* vv = this->GetVariableWatch();
+  return vv && vv->IsWatched(name);
+#else
+  static_cast<void>(name);
+  return false;
+#endif
+}
+
 bool cmMakefile::VariableInitialized(const std::string& var) const
 {
   return this->StateSnapshot.IsInitialized(var);
@@ -2188,6 +2242,15 @@ const char* cmMakefile::GetDefinition(const std::string& name) const
   return def;
 }
 
+std::vector<std::string> const* cmMakefile::GetDefinitionList(
+  const std::string& name) const
+{
+  if (this->IsDefinitionWatched(name)) {
+    return 0;
+  }
+  return this->StateSnapshot.GetDefinitionList(name);
+}
+
 const char* cmMakefile::GetSafeDefinition(const std::string& def) const
 {
   const char* ret = this->GetDefinition(def);
@@ -2840,6 +2903,25 @@ std::string cmMakefile::GetExecutionFilePath() const
   return this->StateSnapshot.GetExecutionListFile();
 }
 
+std::vector<std::string> const* cmMakefile::GetReferencedList(
+  cmListFileArgument const& arg) const
+{
+  std::string const& value = arg.Value;
+  if (arg.Delim != cmListFileArgument::Unquoted || value.size() < 4 ||
+      value[0] != '$' || value[1] != '{' || value[value.size() - 1] != '}') {
+    return 0;
+  }
+  std::string::size_type const end = value.size() - 1;
+  for (std::string::size_type pos = 2; pos < end; ++pos) {
+    char const c = value[pos];
+    if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+          (c >= '0' && c <= '9') || c == '_')) {
+      return 0;
+    }
+  }
+  return this->GetDefinitionList(value.substr(2, end - 2));
+}
+
 bool cmMakefile::ExpandArguments(std::vector<cmListFileArgument> const& inArgs,
                                  std::vector<std::string>& outArgs,
                                  const char* filename) const
@@ -2857,6 +2939,17 @@ bool cmMakefile::ExpandArguments(std::vector<cmListFileArgument> const& inArgs,
       outArgs.push_back(i->Value);
       continue;
     }
+    // Use the elements of a list variable referenced on its own.
+    if (std::vector<std::string> const* elements =
+          this->GetReferencedList(*i)) {
+      for (std::vector<std::string>::const_iterator ei = elements->begin();
+           ei != elements->end(); ++ei) {
+        if (!ei->empty()) {
+          outArgs.push_back(*ei);
+        }
+      }
+      continue;
+    }
     // Expand the variables in the argument.
     value = i->Value;
     this->ExpandVariablesInString(value, false, false, false, filename,
@@ -2890,6 +2983,17 @@ bool cmMakefile::ExpandArguments(
       outArgs.push_back(cmExpandedCommandArgument(i->Value, true));
       continue;
     }
+    // Use the elements of a list variable referenced on its own.
+    if (std::vector<std::string> const* elements =
+          this->GetReferencedList(*i)) {
+      for (std::vector<std::string>::const_iterator ei = elements->begin();
+           ei != elements->end(); ++ei) {
+        if (!ei->empty()) {
+          outArgs.push_back(cmExpandedCommandArgument(*ei, false));
+        }
+      }
+      continue;
+    }
     // Expand the variables in the argument.
     value = i->Value;
     this->ExpandVariablesInString(value, false, false, false, filename,
@@ -3799,7 +3903,7 @@ void cmMakefile::ClearMatches()
   this->MarkVariableAsUsed(nMatchesVariable);
 }
 
-void cmMakefile::StoreMatches(cmsys::RegularExpression& re)
+void cmMakefile::StoreMatches(cmRegularExpression const& re)
 {
   char highest = 0;
   for (int i = 0; i < 10; i++) {
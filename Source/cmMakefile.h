@@ -49,6 +49,7 @@ class cmTestGenerator;
 class cmVariableWatch;
 class cmake;
 class cmMakefileCall;
+class cmRegularExpression;
 class cmCMakePolicyCommand;
 class cmGeneratorExpressionEvaluationFile;
 class cmExportBuildFileGenerator;
@@ -67,6 +68,8 @@ public:
   void MarkVariableAsUsed(const std::string& var);
   /* return true if a variable has been initialized */
   bool VariableInitialized(const std::string&) const;
+  /* return true if a variable_watch is set on a variable */
+  bool IsDefinitionWatched(const std::string&) const;
 
   /**
    * Construct an empty makefile.
@@ -245,6 +248,13 @@ public:
    */
   void AddDefinition(const std::string& name, bool);
 
+  /**
+   * Append elements to the list value of a variable, as list(APPEND)
+   * does.  Long lists grow without copying their whole value.
+   */
+  void AppendDefinition(const std::string& name,
+                        std::vector<std::string> const& values);
+
   /**
    * Remove a variable definition from the build.  This is not valid
    * for cache entries, and will only affect the current makefile.
@@ -419,6 +429,15 @@ public:
    */
   const char* GetDefinition(const std::string&) const;
   const char* GetSafeDefinition(const std::string&) const;
+
+  /**
+   * Get the elements of the list value of a variable, keeping empty
+   * elements, without splitting the value again.  Returns null if the
+   * variable is not set in this makefile or is watched, in which case
+   * GetDefinition must be used.
+   */
+  std::vector<std::string> const* GetDefinitionList(
+    const std::string& name) const;
   const char* GetRequiredDefinition(const std::string& name) const;
   bool IsDefinitionSet(const std::string&) const;
   /**
@@ -758,7 +777,7 @@ public:
   bool IsLoopBlock() const;
 
   void ClearMatches();
-  void StoreMatches(cmsys::RegularExpression& re);
+  void StoreMatches(cmRegularExpression const& re);
 
   cmState::Snapshot GetStateSnapshot() const;
 
@@ -901,6 +920,10 @@ private:
     std::string& errorstr, std::string& source, bool escapeQuotes,
     bool noEscapes, bool atOnly, const char* filename, long line,
     bool removeEmpty, bool replaceAt) const;
+  // The elements of the variable named by an unquoted argument that is
+  // exactly one ${} reference, or null if it must be expanded as a string.
+  std::vector<std::string> const* GetReferencedList(
+    cmListFileArgument const& arg) const;
   /**
    * Old version of GetSourceFileWithOutput(const std::string&) kept for
    * backward-compatibility. It implements a linear search and support
@@ -0,0 +1,133 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmMakefileProfilingData.h"
+
+#include "cmListFileCache.h"
+#include "cmSystemTools.h"
+
+#include "cm_jsoncpp_value.h"
+#include "cm_jsoncpp_writer.h"
+
+#include <cmsys/SystemInformation.hxx>
+
+cmMakefileProfilingData::cmMakefileProfilingData(
+  std::string const& profileFile)
+  : ProfileStream(profileFile.c_str())
+  , JsonWriter(new Json::FastWriter)
+  , ProcessId(0)
+  , StartTime(cmSystemTools::GetTime())
+  , First(true)
+{
+  cmsys::SystemInformation info;
+  this->ProcessId = static_cast<long>(info.GetProcessId());
+
+  // The viewers accept an array of events whose closing bracket is
+  // missing, so the file is usable even if cmake exits early.
+  this->ProfileStream << "[";
+}
+
+cmMakefileProfilingData::~cmMakefileProfilingData()
+{
+  this->ProfileStream << "]\n";
+  delete this->JsonWriter;
+}
+
+void cmMakefileProfilingData::StartEntry(cmListFileFunction const& lff,
+                                         cmListFileContext const& lfc)
+{
+  Json::Value v(Json::objectValue);
+  v["ph"] = "B";
+  v["name"] = cmSystemTools::LowerCase(lff.Name);
+  v["cat"] = "cmake";
+
+  Json::Value& args = v["args"] = Json::objectValue;
+  if (!lff.Arguments.empty()) {
+    std::string functionArgs;
+    for (std::vector<cmListFileArgument>::const_iterator ai =
+           lff.Arguments.begin();
+         ai != lff.Arguments.end(); ++ai) {
+      if (ai != lff.Arguments.begin()) {
+        functionArgs += " ";
+      }
+      functionArgs += ai->Value;
+    }
+    args["functionArgs"] = functionArgs;
+  }
+  std::ostringstream location;
+  location << lfc.FilePath << ":" << lfc.Line;
+  args["location"] = location.str();
+
+  this->WriteEvent(v);
+}
+
+void cmMakefileProfilingData::StartEntry(std::string const& category,
+                                         std::string const& name)
+{
+  Json::Value v(Json::objectValue);
+  v["ph"] = "B";
+  v["name"] = name;
+  v["cat"] = category;
+  this->WriteEvent(v);
+}
+
+void cmMakefileProfilingData::StopEntry()
+{
+  Json::Value v(Json::objectValue);
+  v["ph"] = "E";
+  this->WriteEvent(v);
+}
+
+void cmMakefileProfilingData::RecordGeneratedFile(std::string const& path,
+                                                  unsigned long bytes,
+                                                  bool replaced)
+{
+  Json::Value v(Json::objectValue);
+  v["ph"] = "i";
+  v["name"] = path;
+  v["cat"] = "cmake.file";
+  Json::Value& args = v["args"] = Json::objectValue;
+  args["bytes"] = static_cast<Json::UInt64>(bytes);
+  args["replaced"] = replaced;
+  this->WriteEvent(v);
+}
+
+void cmMakefileProfilingData::RecordGeneratorExpressionEvaluations(
+  std::map<std::string, unsigned long> const& counts)
+{
+  Json::Value v(Json::objectValue);
+  v["ph"] = "i";
+  v["s"] = "g";
+  v["name"] = "generator expression evaluations";
+  v["cat"] = "cmake.generate";
+  Json::Value& args = v["args"] = Json::objectValue;
+  for (std::map<std::string, unsigned long>::const_iterator ci =
+         counts.begin();
+       ci != counts.end(); ++ci) {
+    args[ci->first] = static_cast<Json::UInt64>(ci->second);
+  }
+  this->WriteEvent(v);
+}
+
+void cmMakefileProfilingData::WriteEvent(Json::Value& v)
+{
+  // Timestamps are microseconds since profiling started.
+  double const elapsed = cmSystemTools::GetTime() - this->StartTime;
+  v["ts"] = static_cast<Json::UInt64>(elapsed * 1000000);
+  v["pid"] = static_cast<Json::Int>(this->ProcessId);
+  v["tid"] = 0;
+
+  if (!this->First) {
+    this->ProfileStream << ",";
+  }
+  this->First = false;
+  this->ProfileStream << this->JsonWriter->write(v);
+}
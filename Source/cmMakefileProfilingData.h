@@ -0,0 +1,106 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmMakefileProfilingData_h
+#define cmMakefileProfilingData_h
+
+#include "cmStandardIncludes.h"
+
+#include <cmsys/FStream.hxx>
+
+struct cmListFileContext;
+class cmListFileFunction;
+
+namespace Json {
+class FastWriter;
+class Value;
+}
+
+/** \class cmMakefileProfilingData
+ * \brief Record the time spent in each command and list file.
+ *
+ * Each command invocation, list file and batch of deferred try_compile
+ * checks of the configure step, and each phase of the generate step,
+ * becomes a pair of begin and end events in the Google Trace Event
+ * format, which chrome://tracing and similar viewers display as a call
+ * stack over time.  Events are written to the output file as they occur
+ * so memory use does not grow with the length of the run.
+ */
+class cmMakefileProfilingData
+{
+public:
+  cmMakefileProfilingData(std::string const& profileFile);
+  ~cmMakefileProfilingData();
+
+  /** Whether the output file could be opened.  */
+  bool IsValid() const { return this->ProfileStream ? true : false; }
+
+  /** Begin the event of a command invocation.  */
+  void StartEntry(cmListFileFunction const& lff,
+                  cmListFileContext const& lfc);
+
+  /** Begin an event of the given category that is not a command
+      invocation, such as reading a list file.  */
+  void StartEntry(std::string const& category, std::string const& name);
+
+  /** End the innermost event.  */
+  void StopEntry();
+
+  /** Record the size of a file written by the generate step and whether
+      it replaced the file on disk.  */
+  void RecordGeneratedFile(std::string const& path, unsigned long bytes,
+                           bool replaced);
+
+  /** Record how many generator expressions were evaluated for each
+      target.  */
+  void RecordGeneratorExpressionEvaluations(
+    std::map<std::string, unsigned long> const& counts);
+
+  /** Begin an event when constructed and end it when destroyed.  Does
+      nothing if the profile is null.  */
+  class Scope
+  {
+  public:
+    Scope(cmMakefileProfilingData* data, std::string const& category,
+          std::string const& name)
+      : Data(data)
+    {
+      if (this->Data) {
+        this->Data->StartEntry(category, name);
+      }
+    }
+    ~Scope()
+    {
+      if (this->Data) {
+        this->Data->StopEntry();
+      }
+    }
+
+  private:
+    Scope(Scope const&);
+    Scope& operator=(Scope const&);
+    cmMakefileProfilingData* Data;
+  };
+
+private:
+  cmMakefileProfilingData(cmMakefileProfilingData const&);
+  cmMakefileProfilingData& operator=(cmMakefileProfilingData const&);
+
+  void WriteEvent(Json::Value& v);
+
+  cmsys::ofstream ProfileStream;
+  Json::FastWriter* JsonWriter;
+  long ProcessId;
+  double StartTime;
+  bool First;
+};
+
+#endif
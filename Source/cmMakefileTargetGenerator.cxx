@@ -570,21 +570,41 @@ void cmMakefileTargetGenerator::WriteObjectBuildFile(
 
     if (this->Makefile->IsOn("CMAKE_EXPORT_COMPILE_COMMANDS") &&
         lang_can_export_cmds && compileCommands.size() == 1) {
-      std::string compileCommand = compileCommands[0];
-      this->LocalGenerator->ExpandRuleVariables(compileCommand, vars);
+      std::string const values[CompileCommandValueCount] = {
+        sourceFile, shellObj, objectFileDir
+      };
+      std::string const* compileCommand = this->GetCompileCommandTemplate(
+        lang, flags, definesString, includesString);
+      if (!compileCommand) {
+        std::string const sourceMarker =
+          CompileCommandMarker(CompileCommandSource);
+        std::string const objectMarker =
+          CompileCommandMarker(CompileCommandObject);
+        std::string const objectFileDirMarker =
+          CompileCommandMarker(CompileCommandObjectFileDir);
+        cmLocalGenerator::RuleVariables templateVars = vars;
+        templateVars.Source = sourceMarker.c_str();
+        templateVars.Object = objectMarker.c_str();
+        templateVars.ObjectFileDir = objectFileDirMarker.c_str();
+        std::string command = compileCommands[0];
+        this->LocalGenerator->ExpandRuleVariables(command, templateVars);
+        command.replace(command.find(langFlags), langFlags.size(),
+                        this->GetFlags(lang));
+        std::string langDefines = std::string("$(") + lang + "_DEFINES)";
+        command.replace(command.find(langDefines), langDefines.size(),
+                        this->GetDefines(lang));
+        std::string langIncludes = std::string("$(") + lang + "_INCLUDES)";
+        command.replace(command.find(langIncludes), langIncludes.size(),
+                        this->GetIncludes(lang));
+        compileCommand = &this->SetCompileCommandTemplate(
+          lang, flags, definesString, includesString, command);
+      }
       std::string workingDirectory = this->LocalGenerator->Convert(
         this->LocalGenerator->GetCurrentBinaryDirectory(),
         cmOutputConverter::FULL);
-      compileCommand.replace(compileCommand.find(langFlags), langFlags.size(),
-                             this->GetFlags(lang));
-      std::string langDefines = std::string("$(") + lang + "_DEFINES)";
-      compileCommand.replace(compileCommand.find(langDefines),
-                             langDefines.size(), this->GetDefines(lang));
-      std::string langIncludes = std::string("$(") + lang + "_INCLUDES)";
-      compileCommand.replace(compileCommand.find(langIncludes),
-                             langIncludes.size(), this->GetIncludes(lang));
       this->GlobalGenerator->AddCXXCompileCommand(
-        source.GetFullPath(), workingDirectory, compileCommand);
+        source.GetFullPath(), workingDirectory,
+        ExpandCompileCommandTemplate(*compileCommand, values));
     }
 
     // Maybe insert an include-what-you-use runner.
@@ -75,7 +75,7 @@ cmNinjaTargetGenerator::~cmNinjaTargetGenerator()
 
 cmGeneratedFileStream& cmNinjaTargetGenerator::GetBuildFileStream() const
 {
-  return *this->GetGlobalGenerator()->GetBuildFileStream();
+  return this->LocalGenerator->GetBuildFileStream();
 }
 
 cmGeneratedFileStream& cmNinjaTargetGenerator::GetRulesFileStream() const
@@ -505,6 +505,7 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatements()
   }
   std::vector<cmSourceFile const*> objectSources;
   this->GeneratorTarget->GetObjectSources(objectSources, config);
+  this->WriteTargetLanguageVariables(objectSources);
   for (std::vector<cmSourceFile const*>::const_iterator si =
          objectSources.begin();
        si != objectSources.end(); ++si) {
@@ -540,6 +541,8 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
     language, sourceFileName, objectDir, objectFileName, objectFileDir,
     vars["FLAGS"], vars["DEFINES"], vars["INCLUDES"]);
 
+  this->UseTargetLanguageVariables(language, vars);
+
   std::string comment;
   std::string rule = this->LanguageCompilerRule(language);
 
@@ -610,6 +613,66 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
   }
 }
 
+void cmNinjaTargetGenerator::WriteTargetLanguageVariables(
+  std::vector<cmSourceFile const*> const& objectSources)
+{
+  // The flags, defines and includes of a target are usually the same for
+  // all its sources.  Write them once so that the build statements of
+  // the objects can refer to them instead of repeating them.
+  for (std::vector<cmSourceFile const*>::const_iterator si =
+         objectSources.begin();
+       si != objectSources.end(); ++si) {
+    std::string const language = (*si)->GetLanguage();
+    if (language.empty() || this->TargetLanguageVariables.count(language)) {
+      continue;
+    }
+    cmNinjaVars& shared = this->TargetLanguageVariables[language];
+    cmNinjaVars values;
+    values["FLAGS"] = this->GetFlags(language);
+    values["DEFINES"] = this->GetDefines(language);
+    values["INCLUDES"] = this->GetIncludes(language);
+    for (cmNinjaVars::const_iterator vi = values.begin(); vi != values.end();
+         ++vi) {
+      // Empty variables are not written, so there is nothing to share.
+      if (cmSystemTools::TrimWhitespace(vi->second).empty()) {
+        continue;
+      }
+      cmGlobalNinjaGenerator::WriteVariable(
+        this->GetBuildFileStream(),
+        this->TargetLanguageVariable(language, vi->first), vi->second);
+      shared.insert(*vi);
+    }
+  }
+  if (!this->TargetLanguageVariables.empty()) {
+    this->GetBuildFileStream() << "\n";
+  }
+}
+
+void cmNinjaTargetGenerator::UseTargetLanguageVariables(
+  const std::string& language, cmNinjaVars& vars) const
+{
+  std::map<std::string, cmNinjaVars>::const_iterator tli =
+    this->TargetLanguageVariables.find(language);
+  if (tli == this->TargetLanguageVariables.end()) {
+    return;
+  }
+  for (cmNinjaVars::const_iterator si = tli->second.begin();
+       si != tli->second.end(); ++si) {
+    cmNinjaVars::iterator vi = vars.find(si->first);
+    if (vi != vars.end() && vi->second == si->second) {
+      vi->second = "${" + this->TargetLanguageVariable(language, si->first) +
+        "}";
+    }
+  }
+}
+
+std::string cmNinjaTargetGenerator::TargetLanguageVariable(
+  const std::string& language, const std::string& name) const
+{
+  return language + "_" + name + "__" +
+    cmGlobalNinjaGenerator::EncodeRuleName(this->GeneratorTarget->GetName());
+}
+
 void cmNinjaTargetGenerator::ExportObjectCompileCommand(
   std::string const& language, std::string const& sourceFileName,
   std::string const& objectDir, std::string const& objectFileName,
@@ -620,9 +683,6 @@ void cmNinjaTargetGenerator::ExportObjectCompileCommand(
     return;
   }
 
-  cmLocalGenerator::RuleVariables compileObjectVars;
-  compileObjectVars.Language = language.c_str();
-
   std::string escapedSourceFileName = sourceFileName;
 
   if (!cmSystemTools::FileIsFullPath(sourceFileName.c_str())) {
@@ -635,31 +695,49 @@ void cmNinjaTargetGenerator::ExportObjectCompileCommand(
   escapedSourceFileName = this->LocalGenerator->ConvertToOutputFormat(
     escapedSourceFileName, cmOutputConverter::SHELL);
 
-  compileObjectVars.Source = escapedSourceFileName.c_str();
-  compileObjectVars.Object = objectFileName.c_str();
-  compileObjectVars.ObjectDir = objectDir.c_str();
-  compileObjectVars.ObjectFileDir = objectFileDir.c_str();
-  compileObjectVars.Flags = flags.c_str();
-  compileObjectVars.Defines = defines.c_str();
-  compileObjectVars.Includes = includes.c_str();
-
-  // Rule for compiling object file.
-  std::string compileCmdVar = "CMAKE_";
-  compileCmdVar += language;
-  compileCmdVar += "_COMPILE_OBJECT";
-  std::string compileCmd =
-    this->GetMakefile()->GetRequiredDefinition(compileCmdVar);
-  std::vector<std::string> compileCmds;
-  cmSystemTools::ExpandListArgument(compileCmd, compileCmds);
-
-  for (std::vector<std::string>::iterator i = compileCmds.begin();
-       i != compileCmds.end(); ++i)
-    this->GetLocalGenerator()->ExpandRuleVariables(*i, compileObjectVars);
-
-  std::string cmdLine =
-    this->GetLocalGenerator()->BuildCommandLine(compileCmds);
+  std::string const values[CompileCommandValueCount] = {
+    escapedSourceFileName, objectFileName, objectFileDir
+  };
+
+  std::string const* cmdLine =
+    this->GetCompileCommandTemplate(language, flags, defines, includes);
+  if (!cmdLine) {
+    std::string const sourceMarker =
+      CompileCommandMarker(CompileCommandSource);
+    std::string const objectMarker =
+      CompileCommandMarker(CompileCommandObject);
+    std::string const objectFileDirMarker =
+      CompileCommandMarker(CompileCommandObjectFileDir);
+    cmLocalGenerator::RuleVariables compileObjectVars;
+    compileObjectVars.Language = language.c_str();
+    compileObjectVars.Source = sourceMarker.c_str();
+    compileObjectVars.Object = objectMarker.c_str();
+    compileObjectVars.ObjectDir = objectDir.c_str();
+    compileObjectVars.ObjectFileDir = objectFileDirMarker.c_str();
+    compileObjectVars.Flags = flags.c_str();
+    compileObjectVars.Defines = defines.c_str();
+    compileObjectVars.Includes = includes.c_str();
+
+    // Rule for compiling object file.
+    std::string compileCmdVar = "CMAKE_";
+    compileCmdVar += language;
+    compileCmdVar += "_COMPILE_OBJECT";
+    std::string compileCmd =
+      this->GetMakefile()->GetRequiredDefinition(compileCmdVar);
+    std::vector<std::string> compileCmds;
+    cmSystemTools::ExpandListArgument(compileCmd, compileCmds);
+
+    for (std::vector<std::string>::iterator i = compileCmds.begin();
+         i != compileCmds.end(); ++i)
+      this->GetLocalGenerator()->ExpandRuleVariables(*i, compileObjectVars);
+
+    cmdLine = &this->SetCompileCommandTemplate(
+      language, flags, defines, includes,
+      this->GetLocalGenerator()->BuildCommandLine(compileCmds));
+  }
 
-  this->GetGlobalGenerator()->AddCXXCompileCommand(cmdLine, sourceFileName);
+  this->GetGlobalGenerator()->AddCXXCompileCommand(
+    ExpandCompileCommandTemplate(*cmdLine, values), sourceFileName);
 }
 
 void cmNinjaTargetGenerator::EnsureDirectoryExists(
@@ -114,6 +114,20 @@ protected:
   void WriteObjectBuildStatement(cmSourceFile const* source,
                                  bool writeOrderDependsTargetForTarget);
 
+  /// Write variables holding the flags, defines and includes shared by
+  /// the objects of each language in @a objectSources.
+  void WriteTargetLanguageVariables(
+    std::vector<cmSourceFile const*> const& objectSources);
+
+  /// Replace the values in @a vars that equal a variable written by
+  /// WriteTargetLanguageVariables with a reference to it.
+  void UseTargetLanguageVariables(const std::string& language,
+                                  cmNinjaVars& vars) const;
+
+  /// @return the name of the variable holding @a name for @a language.
+  std::string TargetLanguageVariable(const std::string& language,
+                                     const std::string& name) const;
+
   void ExportObjectCompileCommand(
     std::string const& language, std::string const& sourceFileName,
     std::string const& objectDir, std::string const& objectFileName,
@@ -156,6 +170,8 @@ private:
   /// List of object files for this target.
   cmNinjaDeps Objects;
   std::vector<cmCustomCommand const*> CustomCommands;
+  /// Values written by WriteTargetLanguageVariables for each language.
+  std::map<std::string, cmNinjaVars> TargetLanguageVariables;
 };
 
 #endif // ! cmNinjaTargetGenerator_h
@@ -132,8 +132,8 @@ void cmNinjaUtilityTargetGenerator::Generate()
     }
 
     this->GetGlobalGenerator()->WriteCustomCommandBuild(
-      command, desc, "Utility command for " + this->GetTargetName(),
-      uses_terminal,
+      this->GetBuildFileStream(), command, desc,
+      "Utility command for " + this->GetTargetName(), uses_terminal,
       /*restat*/ true, util_outputs, deps);
 
     this->GetGlobalGenerator()->WritePhonyBuild(
@@ -94,22 +94,10 @@ std::string cmOutputConverter::Convert(const std::string& source,
 
   switch (relative) {
     case HOME:
-      result = this->ConvertToRelativePath(
-        this->GetState()->GetSourceDirectoryComponents(), result);
-      break;
     case START:
-      result = this->ConvertToRelativePath(
-        this->StateSnapshot.GetDirectory().GetCurrentSourceComponents(),
-        result);
-      break;
     case HOME_OUTPUT:
-      result = this->ConvertToRelativePath(
-        this->GetState()->GetBinaryDirectoryComponents(), result);
-      break;
     case START_OUTPUT:
-      result = this->ConvertToRelativePath(
-        this->StateSnapshot.GetDirectory().GetCurrentBinaryComponents(),
-        result);
+      result = this->ConvertToRelativeRootPath(relative, result);
       break;
     case FULL:
       result = cmSystemTools::CollapseFullPath(result);
@@ -175,6 +163,48 @@ std::string cmOutputConverter::Convert(RelativeRoot remote,
   return this->ConvertToOutputFormat(remotePath, output);
 }
 
+std::string const& cmOutputConverter::ConvertToRelativeRootPath(
+  RelativeRoot root, std::string const& remote) const
+{
+  // Generators convert the same paths many times, so remember them.
+  cmState::Directory dir = this->StateSnapshot.GetDirectory();
+  if (this->RelativePathsTopSource != dir.GetRelativePathTopSource() ||
+      this->RelativePathsTopBinary != dir.GetRelativePathTopBinary()) {
+    for (int i = 0; i < 4; ++i) {
+      this->RelativePaths[i].clear();
+    }
+    this->RelativePathsTopSource = dir.GetRelativePathTopSource();
+    this->RelativePathsTopBinary = dir.GetRelativePathTopBinary();
+  }
+
+  std::map<std::string, std::string>& paths =
+    this->RelativePaths[root - HOME];
+  std::map<std::string, std::string>::iterator i = paths.lower_bound(remote);
+  if (i != paths.end() && i->first == remote) {
+    return i->second;
+  }
+
+  std::vector<std::string> const* local = 0;
+  switch (root) {
+    case HOME:
+      local = &this->GetState()->GetSourceDirectoryComponents();
+      break;
+    case START:
+      local = &dir.GetCurrentSourceComponents();
+      break;
+    case HOME_OUTPUT:
+      local = &this->GetState()->GetBinaryDirectoryComponents();
+      break;
+    default:
+      local = &dir.GetCurrentBinaryComponents();
+      break;
+  }
+  return paths
+    .insert(i, std::make_pair(remote,
+                              this->ConvertToRelativePath(*local, remote)))
+    ->second;
+}
+
 static bool cmOutputConverterNotAbove(const char* a, const char* b)
 {
   return (cmSystemTools::ComparePath(a, b) ||
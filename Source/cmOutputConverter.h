@@ -175,6 +175,9 @@ private:
                                                std::string const& result,
                                                OutputFormat format) const;
 
+  std::string const& ConvertToRelativeRootPath(
+    RelativeRoot root, std::string const& remote) const;
+
   static int Shell__CharIsWhitespace(char c);
   static int Shell__CharNeedsQuotesOnUnix(char c);
   static int Shell__CharNeedsQuotesOnWindows(char c);
@@ -190,6 +193,12 @@ private:
   cmState::Snapshot StateSnapshot;
 
   bool LinkScriptShell;
+
+  // Paths converted relative to each of HOME, START, HOME_OUTPUT and
+  // START_OUTPUT, valid while the relative path tops do not change.
+  mutable std::map<std::string, std::string> RelativePaths[4];
+  mutable std::string RelativePathsTopSource;
+  mutable std::string RelativePathsTopBinary;
 };
 
 #endif
@@ -894,6 +894,10 @@ void cmQtAutoGeneratorInitializer::SetupAutoGenerateTarget(
   makefile->AddDefinition(
     "_origin_target_name",
     cmOutputConverter::EscapeForCMake(target->GetName()).c_str());
+  const char* parallel = target->GetProperty("AUTOGEN_PARALLEL");
+  makefile->AddDefinition(
+    "_autogen_parallel",
+    cmOutputConverter::EscapeForCMake(parallel ? parallel : "").c_str());
 
   std::string targetDir = GetAutogenTargetDir(target);
 
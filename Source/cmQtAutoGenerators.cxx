@@ -14,6 +14,7 @@
 #include "cmQtAutoGenerators.h"
 
 #include "cmAlgorithms.h"
+#include "cmFileTimeComparison.h"
 #include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmOutputConverter.h"
@@ -24,7 +25,11 @@
 
 #include <assert.h>
 #include <cmsys/FStream.hxx>
+#include <cmsys/Process.h>
 #include <cmsys/Terminal.h>
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#include <cmsys/SystemInformation.hxx>
+#endif
 
 #include <string.h>
 #if defined(__APPLE__)
@@ -88,7 +93,8 @@ static std::string extractSubDir(const std::string& absPath,
 }
 
 cmQtAutoGenerators::cmQtAutoGenerators()
-  : Verbose(cmsys::SystemTools::GetEnv("VERBOSE") != 0)
+  : ParallelLevel(1)
+  , Verbose(cmsys::SystemTools::GetEnv("VERBOSE") != 0)
   , ColorOutput(true)
   , RunMocFailed(false)
   , RunUicFailed(false)
@@ -160,6 +166,7 @@ bool cmQtAutoGenerators::Run(const std::string& targetDirectory,
 
   this->ReadAutogenInfoFile(mf.get(), targetDirectory, config);
   this->ReadOldMocDefinitionsFile(mf.get(), targetDirectory);
+  this->ReadScanCacheFile(targetDirectory);
 
   this->Init();
 
@@ -168,6 +175,7 @@ bool cmQtAutoGenerators::Run(const std::string& targetDirectory,
   }
 
   this->WriteOldMocDefinitionsFile(targetDirectory);
+  this->WriteScanCacheFile(targetDirectory);
 
   return success;
 }
@@ -307,6 +315,21 @@ bool cmQtAutoGenerators::ReadAutogenInfoFile(
 
   this->RelaxedMode = makefile->IsOn("AM_RELAXED_MODE");
 
+  {
+    std::string parallel = makefile->GetSafeDefinition("AM_PARALLEL");
+    unsigned long level = 0;
+    if (parallel.empty() || parallel == "AUTO") {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+      cmsys::SystemInformation info;
+      info.RunCPUCheck();
+      level = info.GetNumberOfLogicalCPU();
+#endif
+    } else {
+      cmSystemTools::StringToULong(parallel.c_str(), &level);
+    }
+    this->ParallelLevel = level > 1 ? static_cast<unsigned int>(level) : 1;
+  }
+
   return true;
 }
 
@@ -356,6 +379,84 @@ void cmQtAutoGenerators::WriteOldMocDefinitionsFile(
   outfile.close();
 }
 
+void cmQtAutoGenerators::ReadScanCacheFile(
+  const std::string& targetDirectory)
+{
+  std::string filename(cmSystemTools::CollapseFullPath(targetDirectory));
+  cmSystemTools::ConvertToUnixSlashes(filename);
+  filename += "/AutogenScanCache.txt";
+
+  cmsys::ifstream fin(filename.c_str());
+  if (!fin) {
+    return;
+  }
+
+  // Each entry is the name of a scanned file, the moc macro it contains
+  // or "-", and its moc and ui includes, followed by an empty line.
+  // Entries for files changed since the cache was written are skipped.
+  cmFileTimeComparison comp;
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    int newer = 0;
+    bool valid = comp.FileTimeCompare(filename.c_str(), line.c_str(),
+                                      &newer) &&
+      newer == 1;
+    ScanResult result;
+    result.Empty = false;
+    std::string fileName = line;
+    if (cmSystemTools::GetLineFromStream(fin, line) && line != "-") {
+      result.MacroName = line;
+    }
+    while (cmSystemTools::GetLineFromStream(fin, line) && !line.empty()) {
+      if (cmHasLiteralPrefix(line, "moc:")) {
+        result.MocIncludes.push_back(line.substr(4));
+      } else if (cmHasLiteralPrefix(line, "uic:")) {
+        result.UiIncludes.push_back(line.substr(4));
+      }
+    }
+    if (valid) {
+      this->OldScanResults[fileName] = result;
+    }
+  }
+}
+
+void cmQtAutoGenerators::WriteScanCacheFile(
+  const std::string& targetDirectory)
+{
+  std::string filename(cmSystemTools::CollapseFullPath(targetDirectory));
+  cmSystemTools::ConvertToUnixSlashes(filename);
+  filename += "/AutogenScanCache.txt";
+
+  cmsys::ofstream fout(filename.c_str(), std::ios::trunc);
+  if (!fout) {
+    return;
+  }
+  for (std::map<std::string, ScanResult>::const_iterator it =
+         this->ScanResults.begin();
+       it != this->ScanResults.end(); ++it) {
+    ScanResult const& result = it->second;
+    if (result.Empty) {
+      continue;
+    }
+    fout << it->first << "\n";
+    fout << (result.MacroName.empty() ? "-" : result.MacroName) << "\n";
+    for (std::vector<std::string>::const_iterator mit =
+           result.MocIncludes.begin();
+         mit != result.MocIncludes.end(); ++mit) {
+      fout << "moc:" << *mit << "\n";
+    }
+    for (std::vector<std::string>::const_iterator uit =
+           result.UiIncludes.begin();
+         uit != result.UiIncludes.end(); ++uit) {
+      fout << "uic:" << *uit << "\n";
+    }
+    fout << "\n";
+  }
+}
+
 void cmQtAutoGenerators::Init()
 {
   this->TargetBuildSubDir = this->TargetName;
@@ -438,6 +539,57 @@ static std::string ReadAll(const std::string& filename)
   return stream.str();
 }
 
+cmQtAutoGenerators::ScanResult const& cmQtAutoGenerators::ScanFile(
+  const std::string& absFilename)
+{
+  std::map<std::string, ScanResult>::iterator it =
+    this->ScanResults.lower_bound(absFilename);
+  if (it != this->ScanResults.end() && it->first == absFilename) {
+    return it->second;
+  }
+  it = this->ScanResults.insert(it, std::make_pair(absFilename, ScanResult()));
+  ScanResult& result = it->second;
+
+  std::map<std::string, ScanResult>::const_iterator old =
+    this->OldScanResults.find(absFilename);
+  if (old != this->OldScanResults.end()) {
+    result = old->second;
+    return result;
+  }
+
+  const std::string contentsString = ReadAll(absFilename);
+  if (contentsString.empty()) {
+    return result;
+  }
+  result.Empty = false;
+  requiresMocing(contentsString, result.MacroName);
+
+  // first a simple string check for "moc" is *much* faster than the regexp,
+  // and if the string search already fails, we don't have to try the
+  // expensive regexp
+  if (strstr(contentsString.c_str(), "moc") != NULL) {
+    cmsys::RegularExpression mocIncludeRegExp(
+      "[\n][ \t]*#[ \t]*include[ \t]+"
+      "[\"<](([^ \">]+/)?moc_[^ \">/]+\\.cpp|[^ \">]+\\.moc)[\">]");
+    const char* contents = contentsString.c_str();
+    while (mocIncludeRegExp.find(contents)) {
+      result.MocIncludes.push_back(mocIncludeRegExp.match(1));
+      contents += mocIncludeRegExp.end();
+    }
+  }
+  if (strstr(contentsString.c_str(), "ui_") != NULL) {
+    cmsys::RegularExpression uiIncludeRegExp(
+      "[\n][ \t]*#[ \t]*include[ \t]+"
+      "[\"<](([^ \">]+/)?ui_[^ \">/]+\\.h)[\">]");
+    const char* contents = contentsString.c_str();
+    while (uiIncludeRegExp.find(contents)) {
+      result.UiIncludes.push_back(uiIncludeRegExp.match(1));
+      contents += uiIncludeRegExp.end();
+    }
+  }
+  return result;
+}
+
 bool cmQtAutoGenerators::RunAutogen(cmMakefile* makefile)
 {
   if (!cmsys::SystemTools::FileExists(this->OutMocCppFilenameAbs.c_str()) ||
@@ -554,19 +706,15 @@ void cmQtAutoGenerators::ParseCppFile(
   std::map<std::string, std::string>& includedMocs,
   std::map<std::string, std::vector<std::string> >& includedUis)
 {
-  cmsys::RegularExpression mocIncludeRegExp(
-    "[\n][ \t]*#[ \t]*include[ \t]+"
-    "[\"<](([^ \">]+/)?moc_[^ \">/]+\\.cpp|[^ \">]+\\.moc)[\">]");
-
-  const std::string contentsString = ReadAll(absFilename);
-  if (contentsString.empty()) {
+  ScanResult const& scan = this->ScanFile(absFilename);
+  if (scan.Empty) {
     std::stringstream err;
     err << "AUTOGEN: warning: " << absFilename << ": file is empty\n"
         << std::endl;
     this->LogError(err.str());
     return;
   }
-  this->ParseForUic(absFilename, contentsString, includedUis);
+  this->ParseForUic(absFilename, scan, includedUis);
   if (this->MocExecutable.empty()) {
     return;
   }
@@ -576,120 +724,114 @@ void cmQtAutoGenerators::ParseCppFile(
     '/';
   const std::string scannedFileBasename =
     cmsys::SystemTools::GetFilenameWithoutLastExtension(absFilename);
-  std::string macroName;
-  const bool requiresMoc = requiresMocing(contentsString, macroName);
+  const std::string& macroName = scan.MacroName;
+  const bool requiresMoc = !macroName.empty();
   bool dotMocIncluded = false;
   bool mocUnderscoreIncluded = false;
   std::string ownMocUnderscoreFile;
   std::string ownDotMocFile;
   std::string ownMocHeaderFile;
 
-  std::string::size_type matchOffset = 0;
-  // first a simple string check for "moc" is *much* faster than the regexp,
-  // and if the string search already fails, we don't have to try the
-  // expensive regexp
-  if ((strstr(contentsString.c_str(), "moc") != NULL) &&
-      (mocIncludeRegExp.find(contentsString))) {
-    // for every moc include in the file
-    do {
-      const std::string currentMoc = mocIncludeRegExp.match(1);
-
-      std::string basename =
-        cmsys::SystemTools::GetFilenameWithoutLastExtension(currentMoc);
-      const bool moc_style = cmHasLiteralPrefix(basename, "moc_");
-
-      // If the moc include is of the moc_foo.cpp style we expect
-      // the Q_OBJECT class declaration in a header file.
-      // If the moc include is of the foo.moc style we need to look for
-      // a Q_OBJECT macro in the current source file, if it contains the
-      // macro we generate the moc file from the source file.
-      // Q_OBJECT
-      if (moc_style) {
-        // basename should be the part of the moc filename used for
-        // finding the correct header, so we need to remove the moc_ part
-        basename = basename.substr(4);
+  // for every moc include in the file
+  for (std::vector<std::string>::const_iterator mit =
+         scan.MocIncludes.begin();
+       mit != scan.MocIncludes.end(); ++mit) {
+    const std::string& currentMoc = *mit;
+
+    std::string basename =
+      cmsys::SystemTools::GetFilenameWithoutLastExtension(currentMoc);
+    const bool moc_style = cmHasLiteralPrefix(basename, "moc_");
+
+    // If the moc include is of the moc_foo.cpp style we expect
+    // the Q_OBJECT class declaration in a header file.
+    // If the moc include is of the foo.moc style we need to look for
+    // a Q_OBJECT macro in the current source file, if it contains the
+    // macro we generate the moc file from the source file.
+    // Q_OBJECT
+    if (moc_style) {
+      // basename should be the part of the moc filename used for
+      // finding the correct header, so we need to remove the moc_ part
+      basename = basename.substr(4);
+      std::string mocSubDir = extractSubDir(absPath, currentMoc);
+      std::string headerToMoc =
+        findMatchingHeader(absPath, mocSubDir, basename, headerExtensions);
+
+      if (!headerToMoc.empty()) {
+        includedMocs[headerToMoc] = currentMoc;
+        if (basename == scannedFileBasename) {
+          mocUnderscoreIncluded = true;
+          ownMocUnderscoreFile = currentMoc;
+          ownMocHeaderFile = headerToMoc;
+        }
+      } else {
+        std::stringstream err;
+        err << "AUTOGEN: error: " << absFilename << ": The file "
+            << "includes the moc file \"" << currentMoc << "\", "
+            << "but could not find header \"" << basename << '{'
+            << this->JoinExts(headerExtensions) << "}\" ";
+        if (mocSubDir.empty()) {
+          err << "in " << absPath << "\n" << std::endl;
+        } else {
+          err << "neither in " << absPath << " nor in " << mocSubDir << "\n"
+              << std::endl;
+        }
+        this->LogError(err.str());
+        ::exit(EXIT_FAILURE);
+      }
+    } else {
+      std::string fileToMoc = absFilename;
+      if (!requiresMoc || basename != scannedFileBasename) {
         std::string mocSubDir = extractSubDir(absPath, currentMoc);
         std::string headerToMoc =
           findMatchingHeader(absPath, mocSubDir, basename, headerExtensions);
-
         if (!headerToMoc.empty()) {
-          includedMocs[headerToMoc] = currentMoc;
-          if (basename == scannedFileBasename) {
-            mocUnderscoreIncluded = true;
-            ownMocUnderscoreFile = currentMoc;
-            ownMocHeaderFile = headerToMoc;
-          }
-        } else {
-          std::stringstream err;
-          err << "AUTOGEN: error: " << absFilename << ": The file "
-              << "includes the moc file \"" << currentMoc << "\", "
-              << "but could not find header \"" << basename << '{'
-              << this->JoinExts(headerExtensions) << "}\" ";
-          if (mocSubDir.empty()) {
-            err << "in " << absPath << "\n" << std::endl;
-          } else {
-            err << "neither in " << absPath << " nor in " << mocSubDir << "\n"
+          // this is for KDE4 compatibility:
+          fileToMoc = headerToMoc;
+          if (!requiresMoc && basename == scannedFileBasename) {
+            std::stringstream err;
+            err << "AUTOGEN: warning: " << absFilename
+                << ": The file "
+                   "includes the moc file \""
+                << currentMoc << "\", but does not contain a " << macroName
+                << " macro. Running moc on "
+                << "\"" << headerToMoc << "\" ! Include \"moc_" << basename
+                << ".cpp\" for a compatibility with "
+                   "strict mode (see CMAKE_AUTOMOC_RELAXED_MODE).\n"
                 << std::endl;
-          }
-          this->LogError(err.str());
-          ::exit(EXIT_FAILURE);
-        }
-      } else {
-        std::string fileToMoc = absFilename;
-        if (!requiresMoc || basename != scannedFileBasename) {
-          std::string mocSubDir = extractSubDir(absPath, currentMoc);
-          std::string headerToMoc =
-            findMatchingHeader(absPath, mocSubDir, basename, headerExtensions);
-          if (!headerToMoc.empty()) {
-            // this is for KDE4 compatibility:
-            fileToMoc = headerToMoc;
-            if (!requiresMoc && basename == scannedFileBasename) {
-              std::stringstream err;
-              err << "AUTOGEN: warning: " << absFilename
-                  << ": The file "
-                     "includes the moc file \""
-                  << currentMoc << "\", but does not contain a " << macroName
-                  << " macro. Running moc on "
-                  << "\"" << headerToMoc << "\" ! Include \"moc_" << basename
-                  << ".cpp\" for a compatibility with "
-                     "strict mode (see CMAKE_AUTOMOC_RELAXED_MODE).\n"
-                  << std::endl;
-              this->LogError(err.str());
-            } else {
-              std::stringstream err;
-              err << "AUTOGEN: warning: " << absFilename
-                  << ": The file "
-                     "includes the moc file \""
-                  << currentMoc << "\" instead of \"moc_" << basename
-                  << ".cpp\". "
-                     "Running moc on "
-                  << "\"" << headerToMoc << "\" ! Include \"moc_" << basename
-                  << ".cpp\" for compatibility with "
-                     "strict mode (see CMAKE_AUTOMOC_RELAXED_MODE).\n"
-                  << std::endl;
-              this->LogError(err.str());
-            }
+            this->LogError(err.str());
           } else {
             std::stringstream err;
-            err << "AUTOGEN: error: " << absFilename
+            err << "AUTOGEN: warning: " << absFilename
                 << ": The file "
                    "includes the moc file \""
-                << currentMoc
-                << "\", which seems to be the moc file from a different "
-                   "source file. CMake also could not find a matching "
-                   "header.\n"
+                << currentMoc << "\" instead of \"moc_" << basename
+                << ".cpp\". "
+                   "Running moc on "
+                << "\"" << headerToMoc << "\" ! Include \"moc_" << basename
+                << ".cpp\" for compatibility with "
+                   "strict mode (see CMAKE_AUTOMOC_RELAXED_MODE).\n"
                 << std::endl;
             this->LogError(err.str());
-            ::exit(EXIT_FAILURE);
           }
         } else {
-          dotMocIncluded = true;
-          ownDotMocFile = currentMoc;
+          std::stringstream err;
+          err << "AUTOGEN: error: " << absFilename
+              << ": The file "
+                 "includes the moc file \""
+              << currentMoc
+              << "\", which seems to be the moc file from a different "
+                 "source file. CMake also could not find a matching "
+                 "header.\n"
+              << std::endl;
+          this->LogError(err.str());
+          ::exit(EXIT_FAILURE);
         }
-        includedMocs[fileToMoc] = currentMoc;
+      } else {
+        dotMocIncluded = true;
+        ownDotMocFile = currentMoc;
       }
-      matchOffset += mocIncludeRegExp.end();
-    } while (mocIncludeRegExp.find(contentsString.c_str() + matchOffset));
+      includedMocs[fileToMoc] = currentMoc;
+    }
   }
 
   // In this case, check whether the scanned file itself contains a Q_OBJECT.
@@ -736,19 +878,15 @@ void cmQtAutoGenerators::StrictParseCppFile(
   std::map<std::string, std::string>& includedMocs,
   std::map<std::string, std::vector<std::string> >& includedUis)
 {
-  cmsys::RegularExpression mocIncludeRegExp(
-    "[\n][ \t]*#[ \t]*include[ \t]+"
-    "[\"<](([^ \">]+/)?moc_[^ \">/]+\\.cpp|[^ \">]+\\.moc)[\">]");
-
-  const std::string contentsString = ReadAll(absFilename);
-  if (contentsString.empty()) {
+  ScanResult const& scan = this->ScanFile(absFilename);
+  if (scan.Empty) {
     std::stringstream err;
     err << "AUTOGEN: warning: " << absFilename << ": file is empty\n"
         << std::endl;
     this->LogError(err.str());
     return;
   }
-  this->ParseForUic(absFilename, contentsString, includedUis);
+  this->ParseForUic(absFilename, scan, includedUis);
   if (this->MocExecutable.empty()) {
     return;
   }
@@ -761,79 +899,73 @@ void cmQtAutoGenerators::StrictParseCppFile(
 
   bool dotMocIncluded = false;
 
-  std::string::size_type matchOffset = 0;
-  // first a simple string check for "moc" is *much* faster than the regexp,
-  // and if the string search already fails, we don't have to try the
-  // expensive regexp
-  if ((strstr(contentsString.c_str(), "moc") != NULL) &&
-      (mocIncludeRegExp.find(contentsString))) {
-    // for every moc include in the file
-    do {
-      const std::string currentMoc = mocIncludeRegExp.match(1);
-
-      std::string basename =
-        cmsys::SystemTools::GetFilenameWithoutLastExtension(currentMoc);
-      const bool mocUnderscoreStyle = cmHasLiteralPrefix(basename, "moc_");
-
-      // If the moc include is of the moc_foo.cpp style we expect
-      // the Q_OBJECT class declaration in a header file.
-      // If the moc include is of the foo.moc style we need to look for
-      // a Q_OBJECT macro in the current source file, if it contains the
-      // macro we generate the moc file from the source file.
-      if (mocUnderscoreStyle) {
-        // basename should be the part of the moc filename used for
-        // finding the correct header, so we need to remove the moc_ part
-        basename = basename.substr(4);
-        std::string mocSubDir = extractSubDir(absPath, currentMoc);
-        std::string headerToMoc =
-          findMatchingHeader(absPath, mocSubDir, basename, headerExtensions);
-
-        if (!headerToMoc.empty()) {
-          includedMocs[headerToMoc] = currentMoc;
-        } else {
-          std::stringstream err;
-          err << "AUTOGEN: error: " << absFilename << " The file "
-              << "includes the moc file \"" << currentMoc << "\", "
-              << "but could not find header \"" << basename << '{'
-              << this->JoinExts(headerExtensions) << "}\" ";
-          if (mocSubDir.empty()) {
-            err << "in " << absPath << "\n" << std::endl;
-          } else {
-            err << "neither in " << absPath << " nor in " << mocSubDir << "\n"
-                << std::endl;
-          }
-          this->LogError(err.str());
-          ::exit(EXIT_FAILURE);
-        }
+  // for every moc include in the file
+  for (std::vector<std::string>::const_iterator mit =
+         scan.MocIncludes.begin();
+       mit != scan.MocIncludes.end(); ++mit) {
+    const std::string& currentMoc = *mit;
+
+    std::string basename =
+      cmsys::SystemTools::GetFilenameWithoutLastExtension(currentMoc);
+    const bool mocUnderscoreStyle = cmHasLiteralPrefix(basename, "moc_");
+
+    // If the moc include is of the moc_foo.cpp style we expect
+    // the Q_OBJECT class declaration in a header file.
+    // If the moc include is of the foo.moc style we need to look for
+    // a Q_OBJECT macro in the current source file, if it contains the
+    // macro we generate the moc file from the source file.
+    if (mocUnderscoreStyle) {
+      // basename should be the part of the moc filename used for
+      // finding the correct header, so we need to remove the moc_ part
+      basename = basename.substr(4);
+      std::string mocSubDir = extractSubDir(absPath, currentMoc);
+      std::string headerToMoc =
+        findMatchingHeader(absPath, mocSubDir, basename, headerExtensions);
+
+      if (!headerToMoc.empty()) {
+        includedMocs[headerToMoc] = currentMoc;
       } else {
-        if (basename != scannedFileBasename) {
-          std::stringstream err;
-          err << "AUTOGEN: error: " << absFilename
-              << ": The file "
-                 "includes the moc file \""
-              << currentMoc
-              << "\", which seems to be the moc file from a different "
-                 "source file. This is not supported. "
-                 "Include \""
-              << scannedFileBasename << ".moc\" to run "
-                                        "moc on this source file.\n"
+        std::stringstream err;
+        err << "AUTOGEN: error: " << absFilename << " The file "
+            << "includes the moc file \"" << currentMoc << "\", "
+            << "but could not find header \"" << basename << '{'
+            << this->JoinExts(headerExtensions) << "}\" ";
+        if (mocSubDir.empty()) {
+          err << "in " << absPath << "\n" << std::endl;
+        } else {
+          err << "neither in " << absPath << " nor in " << mocSubDir << "\n"
               << std::endl;
-          this->LogError(err.str());
-          ::exit(EXIT_FAILURE);
         }
-        dotMocIncluded = true;
-        includedMocs[absFilename] = currentMoc;
+        this->LogError(err.str());
+        ::exit(EXIT_FAILURE);
+      }
+    } else {
+      if (basename != scannedFileBasename) {
+        std::stringstream err;
+        err << "AUTOGEN: error: " << absFilename
+            << ": The file "
+               "includes the moc file \""
+            << currentMoc
+            << "\", which seems to be the moc file from a different "
+               "source file. This is not supported. "
+               "Include \""
+            << scannedFileBasename << ".moc\" to run "
+                                      "moc on this source file.\n"
+            << std::endl;
+        this->LogError(err.str());
+        ::exit(EXIT_FAILURE);
       }
-      matchOffset += mocIncludeRegExp.end();
-    } while (mocIncludeRegExp.find(contentsString.c_str() + matchOffset));
+      dotMocIncluded = true;
+      includedMocs[absFilename] = currentMoc;
+    }
   }
 
   // In this case, check whether the scanned file itself contains a Q_OBJECT.
   // If this is the case, the moc_foo.cpp should probably be generated from
   // foo.cpp instead of foo.h, because otherwise it won't build.
   // But warn, since this is not how it is supposed to be used.
-  std::string macroName;
-  if (!dotMocIncluded && requiresMocing(contentsString, macroName)) {
+  const std::string& macroName = scan.MacroName;
+  if (!dotMocIncluded && !macroName.empty()) {
     // otherwise always error out since it will not compile:
     std::stringstream err;
     err << "AUTOGEN: error: " << absFilename << ": The file "
@@ -852,49 +984,37 @@ void cmQtAutoGenerators::ParseForUic(
   if (this->UicExecutable.empty()) {
     return;
   }
-  const std::string contentsString = ReadAll(absFilename);
-  if (contentsString.empty()) {
+  ScanResult const& scan = this->ScanFile(absFilename);
+  if (scan.Empty) {
     std::stringstream err;
     err << "AUTOGEN: warning: " << absFilename << ": file is empty\n"
         << std::endl;
     this->LogError(err.str());
     return;
   }
-  this->ParseForUic(absFilename, contentsString, includedUis);
+  this->ParseForUic(absFilename, scan, includedUis);
 }
 
 void cmQtAutoGenerators::ParseForUic(
-  const std::string& absFilename, const std::string& contentsString,
+  const std::string& absFilename, ScanResult const& scan,
   std::map<std::string, std::vector<std::string> >& includedUis)
 {
-  if (this->UicExecutable.empty()) {
+  if (this->UicExecutable.empty() || scan.UiIncludes.empty()) {
     return;
   }
-  cmsys::RegularExpression uiIncludeRegExp(
-    "[\n][ \t]*#[ \t]*include[ \t]+"
-    "[\"<](([^ \">]+/)?ui_[^ \">/]+\\.h)[\">]");
-
-  std::string::size_type matchOffset = 0;
 
   const std::string realName = cmsys::SystemTools::GetRealPath(absFilename);
 
-  matchOffset = 0;
-  if ((strstr(contentsString.c_str(), "ui_") != NULL) &&
-      (uiIncludeRegExp.find(contentsString))) {
-    do {
-      const std::string currentUi = uiIncludeRegExp.match(1);
+  for (std::vector<std::string>::const_iterator uit = scan.UiIncludes.begin();
+       uit != scan.UiIncludes.end(); ++uit) {
+    std::string basename =
+      cmsys::SystemTools::GetFilenameWithoutLastExtension(*uit);
 
-      std::string basename =
-        cmsys::SystemTools::GetFilenameWithoutLastExtension(currentUi);
-
-      // basename should be the part of the ui filename used for
-      // finding the correct header, so we need to remove the ui_ part
-      basename = basename.substr(3);
-
-      includedUis[realName].push_back(basename);
+    // basename should be the part of the ui filename used for
+    // finding the correct header, so we need to remove the ui_ part
+    basename = basename.substr(3);
 
-      matchOffset += uiIncludeRegExp.end();
-    } while (uiIncludeRegExp.find(contentsString.c_str() + matchOffset));
+    includedUis[realName].push_back(basename);
   }
 }
 
@@ -937,7 +1057,7 @@ void cmQtAutoGenerators::ParseHeaders(
   for (std::set<std::string>::const_iterator hIt = absHeaders.begin();
        hIt != absHeaders.end(); ++hIt) {
     const std::string& headerName = *hIt;
-    const std::string contents = ReadAll(headerName);
+    ScanResult const& scan = this->ScanFile(headerName);
 
     if (!this->MocExecutable.empty() &&
         includedMocs.find(headerName) == includedMocs.end()) {
@@ -947,8 +1067,7 @@ void cmQtAutoGenerators::ParseHeaders(
         this->LogInfo(err.str());
       }
 
-      std::string macroName;
-      if (requiresMocing(contents, macroName)) {
+      if (!scan.MacroName.empty()) {
         const std::string parentDir =
           this->TargetBuildSubDir + this->SourceRelativePath(headerName);
         const std::string basename =
@@ -957,7 +1076,7 @@ void cmQtAutoGenerators::ParseHeaders(
         notIncludedMocs[headerName] = currentMoc;
       }
     }
-    this->ParseForUic(headerName, contents, includedUis);
+    this->ParseForUic(headerName, scan, includedUis);
   }
 }
 
@@ -989,11 +1108,7 @@ bool cmQtAutoGenerators::GenerateMocFiles(
   for (std::map<std::string, std::string>::const_iterator it =
          includedMocs.begin();
        it != includedMocs.end(); ++it) {
-    if (!this->GenerateMoc(it->first, it->second)) {
-      if (this->RunMocFailed) {
-        return false;
-      }
-    }
+    this->GenerateMoc(it->first, it->second);
   }
 
   // generate moc files that are _not_ included by source files.
@@ -1003,13 +1118,13 @@ bool cmQtAutoGenerators::GenerateMocFiles(
        it != notIncludedMocs.end(); ++it) {
     if (this->GenerateMoc(it->first, it->second)) {
       automocCppChanged = true;
-    } else {
-      if (this->RunMocFailed) {
-        return false;
-      }
     }
   }
 
+  if (!this->RunQueuedCommands()) {
+    return false;
+  }
+
   // compose _automoc.cpp content
   std::string automocSource;
   {
@@ -1101,18 +1216,10 @@ bool cmQtAutoGenerators::GenerateMoc(const std::string& sourceFile,
       this->LogCommand(command);
     }
 
-    std::string output;
-    int retVal = 0;
-    bool result =
-      cmSystemTools::RunSingleCommand(command, &output, &output, &retVal);
-    if (!result || retVal) {
-      std::stringstream err;
-      err << "AUTOGEN: error: process for " << mocFilePath << " failed:\n"
-          << output << std::endl;
-      this->LogError(err.str());
-      this->RunMocFailed = true;
-      cmSystemTools::RemoveFile(mocFilePath);
-    }
+    std::string err = "AUTOGEN: error: process for ";
+    err += mocFilePath;
+    err += " failed:\n";
+    this->QueueCommand(command, mocFilePath, err, &this->RunMocFailed);
     return true;
   }
   return false;
@@ -1166,15 +1273,11 @@ bool cmQtAutoGenerators::GenerateUiFiles(
     for (std::map<std::string, std::string>::const_iterator sit =
            it->second.begin();
          sit != it->second.end(); ++sit) {
-      if (!this->GenerateUi(it->first, sit->first, sit->second)) {
-        if (this->RunUicFailed) {
-          return false;
-        }
-      }
+      this->GenerateUi(it->first, sit->first, sit->second);
     }
   }
 
-  return true;
+  return this->RunQueuedCommands();
 }
 
 bool cmQtAutoGenerators::GenerateUi(const std::string& realName,
@@ -1218,20 +1321,12 @@ bool cmQtAutoGenerators::GenerateUi(const std::string& realName,
     if (this->Verbose) {
       this->LogCommand(command);
     }
-    std::string output;
-    int retVal = 0;
-    bool result =
-      cmSystemTools::RunSingleCommand(command, &output, &output, &retVal);
-    if (!result || retVal) {
-      std::stringstream err;
-      err << "AUTOUIC: error: process for " << uiOutputFile
-          << " needed by\n \"" << realName << "\"\nfailed:\n"
-          << output << std::endl;
-      this->LogError(err.str());
-      this->RunUicFailed = true;
-      cmSystemTools::RemoveFile(uiOutputFile);
-      return false;
-    }
+    std::string err = "AUTOUIC: error: process for ";
+    err += uiOutputFile;
+    err += " needed by\n \"";
+    err += realName;
+    err += "\"\nfailed:\n";
+    this->QueueCommand(command, uiOutputFile, err, &this->RunUicFailed);
     return true;
   }
   return false;
@@ -1289,13 +1384,9 @@ bool cmQtAutoGenerators::GenerateQrcFiles()
   for (std::map<std::string, std::string>::const_iterator si =
          qrcGenMap.begin();
        si != qrcGenMap.end(); ++si) {
-    if (!this->GenerateQrc(si->first, si->second)) {
-      if (this->RunRccFailed) {
-        return false;
-      }
-    }
+    this->GenerateQrc(si->first, si->second);
   }
-  return true;
+  return this->RunQueuedCommands();
 }
 
 bool cmQtAutoGenerators::GenerateQrc(const std::string& qrcInputFile,
@@ -1339,23 +1430,114 @@ bool cmQtAutoGenerators::GenerateQrc(const std::string& qrcInputFile,
     if (this->Verbose) {
       this->LogCommand(command);
     }
-    std::string output;
-    int retVal = 0;
-    bool result =
-      cmSystemTools::RunSingleCommand(command, &output, &output, &retVal);
-    if (!result || retVal) {
-      std::stringstream err;
-      err << "AUTORCC: error: process for " << qrcOutputFile << " failed:\n"
-          << output << std::endl;
-      this->LogError(err.str());
-      this->RunRccFailed = true;
-      cmSystemTools::RemoveFile(qrcBuildFile);
-      return false;
-    }
+    std::string err = "AUTORCC: error: process for ";
+    err += qrcOutputFile;
+    err += " failed:\n";
+    this->QueueCommand(command, qrcBuildFile, err, &this->RunRccFailed);
   }
   return true;
 }
 
+void cmQtAutoGenerators::QueueCommand(const std::vector<std::string>& command,
+                                      const std::string& outputFile,
+                                      const std::string& errorMessage,
+                                      bool* failed)
+{
+  GeneratorJob job;
+  job.Command = command;
+  job.OutputFile = outputFile;
+  job.ErrorMessage = errorMessage;
+  job.Failed = failed;
+  this->Jobs.push_back(job);
+}
+
+// A queued command that has been started and the output it produced.
+struct cmQtAutoGeneratorsProcess
+{
+  size_t Job;
+  cmsysProcess* Process;
+  std::string Output;
+};
+
+bool cmQtAutoGenerators::RunQueuedCommands()
+{
+  std::vector<GeneratorJob> jobs;
+  jobs.swap(this->Jobs);
+
+  // Run up to ParallelLevel commands at once.  Once a command fails no
+  // more are started, but those already running are waited for.
+  bool success = true;
+  std::vector<cmQtAutoGeneratorsProcess> running;
+  size_t next = 0;
+  while ((success && next < jobs.size()) || !running.empty()) {
+    while (success && next < jobs.size() &&
+           running.size() < this->ParallelLevel) {
+      std::vector<const char*> argv;
+      for (std::vector<std::string>::const_iterator ai =
+             jobs[next].Command.begin();
+           ai != jobs[next].Command.end(); ++ai) {
+        argv.push_back(ai->c_str());
+      }
+      argv.push_back(0);
+
+      cmQtAutoGeneratorsProcess proc;
+      proc.Job = next++;
+      proc.Process = cmsysProcess_New();
+      cmsysProcess_SetCommand(proc.Process, &*argv.begin());
+      cmsysProcess_SetOption(proc.Process, cmsysProcess_Option_HideWindow,
+                             1);
+      cmsysProcess_SetOption(proc.Process, cmsysProcess_Option_MergeOutput,
+                             1);
+      cmsysProcess_Execute(proc.Process);
+      running.push_back(proc);
+    }
+
+    for (size_t ri = 0; ri < running.size();) {
+      cmQtAutoGeneratorsProcess& proc = running[ri];
+      char* data;
+      int length;
+      int pipe;
+      double timeout = 0.01;
+      while ((pipe = cmsysProcess_WaitForData(proc.Process, &data, &length,
+                                              &timeout)) != 0 &&
+             pipe != cmsysProcess_Pipe_Timeout) {
+        proc.Output.append(data, length);
+      }
+      if (pipe == cmsysProcess_Pipe_Timeout) {
+        ++ri;
+        continue;
+      }
+
+      cmsysProcess_WaitForExit(proc.Process, 0);
+      bool failed = true;
+      switch (cmsysProcess_GetState(proc.Process)) {
+        case cmsysProcess_State_Exited:
+          failed = cmsysProcess_GetExitValue(proc.Process) != 0;
+          break;
+        case cmsysProcess_State_Exception:
+          proc.Output += cmsysProcess_GetExceptionString(proc.Process);
+          break;
+        default:
+          proc.Output += cmsysProcess_GetErrorString(proc.Process);
+          break;
+      }
+      cmsysProcess_Delete(proc.Process);
+
+      if (failed) {
+        GeneratorJob const& job = jobs[proc.Job];
+        std::stringstream err;
+        err << job.ErrorMessage << proc.Output << std::endl;
+        this->LogError(err.str());
+        *job.Failed = true;
+        cmSystemTools::RemoveFile(job.OutputFile);
+        success = false;
+      }
+      running.erase(running.begin() + ri);
+    }
+  }
+  return success;
+}
+
 std::string cmQtAutoGenerators::SourceRelativePath(const std::string& filename)
 {
   std::string pathRel;
@@ -36,6 +36,8 @@ private:
   bool ReadOldMocDefinitionsFile(cmMakefile* makefile,
                                  const std::string& targetDirectory);
   void WriteOldMocDefinitionsFile(const std::string& targetDirectory);
+  void ReadScanCacheFile(const std::string& targetDirectory);
+  void WriteScanCacheFile(const std::string& targetDirectory);
 
   std::string MakeCompileSettingsString(cmMakefile* makefile);
 
@@ -73,8 +75,23 @@ private:
     std::map<std::string, std::string>& notIncludedMocs,
     std::map<std::string, std::vector<std::string> >& includedUis);
 
+  // What scanning the contents of a file found.  This is cached between
+  // runs for files older than the cache file.
+  struct ScanResult
+  {
+    ScanResult()
+      : Empty(true)
+    {
+    }
+    bool Empty;
+    std::string MacroName;
+    std::vector<std::string> MocIncludes;
+    std::vector<std::string> UiIncludes;
+  };
+  ScanResult const& ScanFile(const std::string& absFilename);
+
   void ParseForUic(
-    const std::string& fileName, const std::string& contentsString,
+    const std::string& fileName, ScanResult const& scan,
     std::map<std::string, std::vector<std::string> >& includedUis);
 
   void ParseForUic(
@@ -103,6 +120,22 @@ private:
   bool InputFilesNewerThanQrc(const std::string& qrcFile,
                               const std::string& rccOutput);
 
+  // A moc, uic or rcc invocation waiting to run.  If it fails the error
+  // is logged with the output of the tool, the output file is removed,
+  // and the flag is set.
+  struct GeneratorJob
+  {
+    std::vector<std::string> Command;
+    std::string OutputFile;
+    std::string ErrorMessage;
+    bool* Failed;
+  };
+  void QueueCommand(const std::vector<std::string>& command,
+                    const std::string& outputFile,
+                    const std::string& errorMessage, bool* failed);
+  bool RunQueuedCommands();
+  std::vector<GeneratorJob> Jobs;
+
   std::string QtMajorVersion;
   std::string Sources;
   std::vector<std::string> RccSources;
@@ -136,6 +169,10 @@ private:
   std::map<std::string, std::string> RccOptions;
   std::map<std::string, std::vector<std::string> > RccInputs;
 
+  std::map<std::string, ScanResult> OldScanResults;
+  std::map<std::string, ScanResult> ScanResults;
+
+  unsigned int ParallelLevel;
   bool IncludeProjectDirsBefore;
   bool Verbose;
   bool ColorOutput;
@@ -0,0 +1,839 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmRegularExpression.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+#include <bitset>
+#include <string.h>
+
+// A compiled expression.  Instructions are run by a Pike VM: a SPLIT
+// continues at both targets, the first with higher priority, so the
+// first thread to reach MATCH finds the same match as a backtracking
+// matcher trying alternatives in order.
+class cmRegularExpressionProgram
+{
+public:
+  enum OpCode
+  {
+    Char,  // match character X
+    Any,   // match any character
+    Class, // match a character in Classes[X]
+    Bol,   // assert beginning of input
+    Eol,   // assert end of input
+    Save,  // record the position in capture slot X
+    Split, // continue at X and at Y
+    Jump,  // continue at X
+    Match
+  };
+  struct Instruction
+  {
+    OpCode Op;
+    int X;
+    int Y;
+  };
+
+  cmRegularExpressionProgram()
+    : Slots(2)
+    , Anchored(false)
+    , FirstChar(-1)
+    , Joins(0)
+    , References(0)
+  {
+  }
+
+  std::vector<Instruction> Code;
+  // Index among the instructions reached by a jump, or -1.  A backtracking
+  // matcher reaching another instruction twice at the same position must
+  // have passed the same jump target before, so only these are tracked.
+  std::vector<int> JoinIndex;
+  std::vector<std::bitset<256> > Classes;
+  int Slots;
+  bool Anchored;
+  int FirstChar;
+  int Joins;
+  unsigned int References;
+};
+
+// Translate a pattern accepted by cmsys::RegularExpression into program
+// instructions, following its grammar and its choice of which of
+// several matches to report.
+class cmRegularExpressionCompiler
+{
+public:
+  cmRegularExpressionCompiler(const char* pattern,
+                              cmRegularExpressionProgram& program)
+    : Parse(pattern)
+    , Program(program)
+    , Groups(0)
+  {
+  }
+
+  bool Compile();
+
+private:
+  enum NodeKind
+  {
+    Literal,
+    AnyChar,
+    CharClass,
+    Begin,
+    End,
+    Group,
+    Concat,
+    Alternate,
+    Star,
+    Plus,
+    Optional,
+    Empty
+  };
+  struct Node
+  {
+    NodeKind Kind;
+    int Value;
+    std::vector<int> Children;
+  };
+
+  int AddNode(NodeKind kind, int value = 0);
+  int ParseRegex(bool paren);
+  int ParseBranch();
+  int ParsePiece();
+  int ParseAtom();
+  int ParseClass();
+  void Emit(int node);
+  int Add(cmRegularExpressionProgram::OpCode op, int x = 0, int y = 0);
+  int LeadingNode(int node, bool throughRepeat) const;
+
+  const char* Parse;
+  cmRegularExpressionProgram& Program;
+  std::vector<Node> Nodes;
+  int Groups;
+};
+
+int cmRegularExpressionCompiler::AddNode(NodeKind kind, int value)
+{
+  Node node;
+  node.Kind = kind;
+  node.Value = value;
+  this->Nodes.push_back(node);
+  return static_cast<int>(this->Nodes.size()) - 1;
+}
+
+int cmRegularExpressionCompiler::ParseRegex(bool paren)
+{
+  int group = 0;
+  if (paren) {
+    if (this->Groups + 1 >= cmRegularExpression::NSUBEXP) {
+      return -1;
+    }
+    group = ++this->Groups;
+  }
+
+  std::vector<int> branches;
+  int branch = this->ParseBranch();
+  if (branch < 0) {
+    return -1;
+  }
+  branches.push_back(branch);
+  while (*this->Parse == '|') {
+    ++this->Parse;
+    branch = this->ParseBranch();
+    if (branch < 0) {
+      return -1;
+    }
+    branches.push_back(branch);
+  }
+
+  if (paren ? *this->Parse++ != ')' : *this->Parse != '\0') {
+    return -1;
+  }
+
+  int node = branches[0];
+  if (branches.size() > 1) {
+    node = this->AddNode(Alternate);
+    this->Nodes[node].Children = branches;
+  }
+  if (paren) {
+    int const inner = node;
+    node = this->AddNode(Group, group);
+    this->Nodes[node].Children.push_back(inner);
+  }
+  return node;
+}
+
+int cmRegularExpressionCompiler::ParseBranch()
+{
+  std::vector<int> pieces;
+  while (*this->Parse != '\0' && *this->Parse != '|' &&
+         *this->Parse != ')') {
+    int const piece = this->ParsePiece();
+    if (piece < 0) {
+      return -1;
+    }
+    pieces.push_back(piece);
+  }
+  if (pieces.empty()) {
+    return this->AddNode(Empty);
+  }
+  if (pieces.size() == 1) {
+    return pieces[0];
+  }
+  int const node = this->AddNode(Concat);
+  this->Nodes[node].Children = pieces;
+  return node;
+}
+
+int cmRegularExpressionCompiler::ParsePiece()
+{
+  int const atom = this->ParseAtom();
+  if (atom < 0) {
+    return -1;
+  }
+  NodeKind kind;
+  switch (*this->Parse) {
+    case '*':
+      kind = Star;
+      break;
+    case '+':
+      kind = Plus;
+      break;
+    case '?':
+      kind = Optional;
+      break;
+    default:
+      return atom;
+  }
+  ++this->Parse;
+  int const node = this->AddNode(kind);
+  this->Nodes[node].Children.push_back(atom);
+  return node;
+}
+
+int cmRegularExpressionCompiler::ParseAtom()
+{
+  char const c = *this->Parse++;
+  switch (c) {
+    case '^':
+      return this->AddNode(Begin);
+    case '$':
+      return this->AddNode(End);
+    case '.':
+      return this->AddNode(AnyChar);
+    case '[':
+      return this->ParseClass();
+    case '(':
+      return this->ParseRegex(true);
+    case '\\':
+      if (*this->Parse == '\0') {
+        return -1;
+      }
+      return this->AddNode(Literal,
+                           static_cast<unsigned char>(*this->Parse++));
+    case '\0':
+    case '|':
+    case ')':
+    case '?':
+    case '+':
+    case '*':
+      return -1;
+    default:
+      return this->AddNode(Literal, static_cast<unsigned char>(c));
+  }
+}
+
+int cmRegularExpressionCompiler::ParseClass()
+{
+  std::bitset<256> set;
+  bool negate = false;
+  if (*this->Parse == '^') {
+    negate = true;
+    ++this->Parse;
+  }
+  if (*this->Parse == ']' || *this->Parse == '-') {
+    set.set(static_cast<unsigned char>(*this->Parse++));
+  }
+  while (*this->Parse != '\0' && *this->Parse != ']') {
+    if (*this->Parse == '-') {
+      ++this->Parse;
+      if (*this->Parse == ']' || *this->Parse == '\0') {
+        set.set('-');
+      } else {
+        // A range starts after the character before the '-', which has
+        // been added already.
+        int first = static_cast<unsigned char>(this->Parse[-2]) + 1;
+        int const last = static_cast<unsigned char>(*this->Parse);
+        if (first > last + 1) {
+          return -1;
+        }
+        for (; first <= last; ++first) {
+          set.set(static_cast<size_t>(first));
+        }
+        ++this->Parse;
+      }
+    } else {
+      set.set(static_cast<unsigned char>(*this->Parse++));
+    }
+  }
+  if (*this->Parse != ']') {
+    return -1;
+  }
+  ++this->Parse;
+
+  if (negate) {
+    set.flip();
+  }
+  set.reset(0);
+  this->Program.Classes.push_back(set);
+  return this->AddNode(CharClass,
+                       static_cast<int>(this->Program.Classes.size()) - 1);
+}
+
+int cmRegularExpressionCompiler::Add(cmRegularExpressionProgram::OpCode op,
+                                     int x, int y)
+{
+  cmRegularExpressionProgram::Instruction instruction;
+  instruction.Op = op;
+  instruction.X = x;
+  instruction.Y = y;
+  this->Program.Code.push_back(instruction);
+  return static_cast<int>(this->Program.Code.size()) - 1;
+}
+
+void cmRegularExpressionCompiler::Emit(int n)
+{
+  typedef cmRegularExpressionProgram P;
+  // Copy what we need; Nodes is not modified while emitting, but keep
+  // the code independent of references into it.
+  NodeKind const kind = this->Nodes[n].Kind;
+  int const value = this->Nodes[n].Value;
+  std::vector<int> const children = this->Nodes[n].Children;
+  std::vector<P::Instruction>& code = this->Program.Code;
+  switch (kind) {
+    case Literal:
+      this->Add(P::Char, value);
+      break;
+    case AnyChar:
+      this->Add(P::Any);
+      break;
+    case CharClass:
+      this->Add(P::Class, value);
+      break;
+    case Begin:
+      this->Add(P::Bol);
+      break;
+    case End:
+      this->Add(P::Eol);
+      break;
+    case Group:
+      this->Add(P::Save, 2 * value);
+      this->Emit(children[0]);
+      this->Add(P::Save, 2 * value + 1);
+      break;
+    case Concat:
+      for (std::vector<int>::const_iterator ci = children.begin();
+           ci != children.end(); ++ci) {
+        this->Emit(*ci);
+      }
+      break;
+    case Alternate: {
+      // Try the alternatives in order.
+      std::vector<int> jumps;
+      for (size_t i = 0; i + 1 < children.size(); ++i) {
+        int const split = this->Add(P::Split);
+        code[split].X = split + 1;
+        this->Emit(children[i]);
+        jumps.push_back(this->Add(P::Jump));
+        code[split].Y = static_cast<int>(code.size());
+      }
+      this->Emit(children.back());
+      for (std::vector<int>::const_iterator ji = jumps.begin();
+           ji != jumps.end(); ++ji) {
+        code[*ji].X = static_cast<int>(code.size());
+      }
+    } break;
+    case Star: {
+      // Repeat greedily.
+      int const split = this->Add(P::Split);
+      code[split].X = split + 1;
+      this->Emit(children[0]);
+      this->Add(P::Jump, split);
+      code[split].Y = static_cast<int>(code.size());
+    } break;
+    case Plus: {
+      int const loop = static_cast<int>(code.size());
+      this->Emit(children[0]);
+      int const split = this->Add(P::Split, loop);
+      code[split].Y = split + 1;
+    } break;
+    case Optional: {
+      int const split = this->Add(P::Split);
+      code[split].X = split + 1;
+      this->Emit(children[0]);
+      code[split].Y = static_cast<int>(code.size());
+    } break;
+    case Empty:
+      break;
+  }
+}
+
+int cmRegularExpressionCompiler::LeadingNode(int n, bool throughRepeat) const
+{
+  for (;;) {
+    Node const& node = this->Nodes[n];
+    if (node.Kind == Concat || node.Kind == Group ||
+        (node.Kind == Plus && throughRepeat)) {
+      n = node.Children[0];
+    } else {
+      return n;
+    }
+  }
+}
+
+bool cmRegularExpressionCompiler::Compile()
+{
+  typedef cmRegularExpressionProgram P;
+  int const root = this->ParseRegex(false);
+  if (root < 0) {
+    return false;
+  }
+  this->Program.Slots = 2 * (this->Groups + 1);
+
+  // Every match of an expression whose first element is '^' starts at
+  // the beginning of the input, and of one whose first element is a
+  // literal character starts at that character.
+  int const first = this->LeadingNode(root, false);
+  this->Program.Anchored = this->Nodes[first].Kind == Begin;
+  int const leading = this->LeadingNode(root, true);
+  if (this->Nodes[leading].Kind == Literal) {
+    this->Program.FirstChar = this->Nodes[leading].Value;
+  }
+
+  this->Add(P::Save, 0);
+  this->Emit(root);
+  this->Add(P::Save, 1);
+  this->Add(P::Match);
+
+  std::vector<P::Instruction> const& code = this->Program.Code;
+  std::vector<int>& joinIndex = this->Program.JoinIndex;
+  joinIndex.assign(code.size(), -1);
+  joinIndex[0] = 0;
+  for (std::vector<P::Instruction>::const_iterator i = code.begin();
+       i != code.end(); ++i) {
+    if (i->Op == P::Split) {
+      joinIndex[i->Y] = 0;
+    }
+    if (i->Op == P::Split || i->Op == P::Jump) {
+      joinIndex[i->X] = 0;
+    }
+  }
+  for (std::vector<int>::iterator i = joinIndex.begin(); i != joinIndex.end();
+       ++i) {
+    if (*i == 0) {
+      *i = this->Program.Joins++;
+    }
+  }
+  return true;
+}
+
+// Compiled expressions shared by all cmRegularExpression instances.
+class cmRegularExpressionCache
+{
+public:
+  ~cmRegularExpressionCache() { this->Clear(); }
+
+  cmRegularExpressionProgram* Get(std::string const& pattern)
+  {
+    std::map<std::string, cmRegularExpressionProgram*>::iterator i =
+      this->Programs.find(pattern);
+    if (i == this->Programs.end()) {
+      return 0;
+    }
+    ++i->second->References;
+    return i->second;
+  }
+
+  void Insert(std::string const& pattern, cmRegularExpressionProgram* p)
+  {
+    // Patterns built from variable values may all be different.  Bound
+    // the memory held for them by starting over when the cache is full.
+    if (this->Programs.size() >= 1024) {
+      this->Clear();
+    }
+    ++p->References;
+    this->Programs[pattern] = p;
+  }
+
+  static void Release(cmRegularExpressionProgram* p)
+  {
+    if (--p->References == 0) {
+      delete p;
+    }
+  }
+
+private:
+  void Clear()
+  {
+    for (std::map<std::string, cmRegularExpressionProgram*>::iterator i =
+           this->Programs.begin();
+         i != this->Programs.end(); ++i) {
+      Release(i->second);
+    }
+    this->Programs.clear();
+  }
+
+  std::map<std::string, cmRegularExpressionProgram*> Programs;
+};
+
+static cmRegularExpressionCache& cmRegularExpressionGetCache()
+{
+  static cmRegularExpressionCache cache;
+  return cache;
+}
+
+cmRegularExpression::cmRegularExpression()
+  : Program(0)
+  , SearchString(0)
+{
+  for (int i = 0; i < NSUBEXP; ++i) {
+    this->StartP[i] = this->EndP[i] = 0;
+  }
+}
+
+cmRegularExpression::cmRegularExpression(std::string const& pattern)
+  : Program(0)
+  , SearchString(0)
+{
+  for (int i = 0; i < NSUBEXP; ++i) {
+    this->StartP[i] = this->EndP[i] = 0;
+  }
+  this->compile(pattern);
+}
+
+cmRegularExpression::~cmRegularExpression()
+{
+  this->Release();
+}
+
+void cmRegularExpression::Release()
+{
+  if (this->Program) {
+    cmRegularExpressionCache::Release(this->Program);
+    this->Program = 0;
+  }
+}
+
+bool cmRegularExpression::compile(std::string const& pattern)
+{
+  this->Release();
+  cmRegularExpressionCache& cache = cmRegularExpressionGetCache();
+  this->Program = cache.Get(pattern);
+  if (!this->Program) {
+    // Let the reference implementation validate the pattern and report
+    // any error in its own words.
+    cmsys::RegularExpression reference;
+    if (!reference.compile(pattern)) {
+      return false;
+    }
+    cmRegularExpressionProgram* program = new cmRegularExpressionProgram;
+    cmRegularExpressionCompiler compiler(pattern.c_str(), *program);
+    if (!compiler.Compile()) {
+      delete program;
+      return false;
+    }
+    cache.Insert(pattern, program);
+    ++program->References;
+    this->Program = program;
+  }
+  return true;
+}
+
+void cmRegularExpression::ResetList(ThreadList& list)
+{
+  list.Size = 0;
+  if (++list.Generation == 0) {
+    std::fill(list.Marks.begin(), list.Marks.end(), 0);
+    list.Generation = 1;
+  }
+}
+
+void cmRegularExpression::AddThread(ThreadList& list, int pc,
+                                    const char** captures, const char* sp)
+{
+  typedef cmRegularExpressionProgram P;
+  if (list.Marks[pc] == list.Generation) {
+    // A thread with higher priority already reached this instruction
+    // at this position.
+    return;
+  }
+  list.Marks[pc] = list.Generation;
+  P::Instruction const& instruction = this->Program->Code[pc];
+  switch (instruction.Op) {
+    case P::Jump:
+      this->AddThread(list, instruction.X, captures, sp);
+      break;
+    case P::Split:
+      this->AddThread(list, instruction.X, captures, sp);
+      this->AddThread(list, instruction.Y, captures, sp);
+      break;
+    case P::Save: {
+      const char* saved = captures[instruction.X];
+      captures[instruction.X] = sp;
+      this->AddThread(list, pc + 1, captures, sp);
+      captures[instruction.X] = saved;
+    } break;
+    case P::Bol:
+      if (sp == this->SearchString) {
+        this->AddThread(list, pc + 1, captures, sp);
+      }
+      break;
+    case P::Eol:
+      if (*sp == '\0') {
+        this->AddThread(list, pc + 1, captures, sp);
+      }
+      break;
+    default: {
+      int const slots = this->Program->Slots;
+      list.Pcs[list.Size] = pc;
+      std::copy(captures, captures + slots,
+                list.Captures.begin() + list.Size * slots);
+      ++list.Size;
+    } break;
+  }
+}
+
+bool cmRegularExpression::find(const char* s)
+{
+  this->SearchString = s;
+  if (!this->Program) {
+    return false;
+  }
+  int const slots = this->Program->Slots;
+
+  // Backtrack while a bit per instruction and input position is cheap
+  // to keep, and simulate all threads at once otherwise.
+  const char* found[2 * NSUBEXP];
+  size_t const length = strlen(s);
+  size_t const states =
+    static_cast<size_t>(this->Program->Joins) * (length + 1);
+  bool const matched = states <= 256 * 1024
+    ? this->FindBacktrack(s, length, found)
+    : this->FindParallel(s, found);
+  if (!matched) {
+    return false;
+  }
+  for (int i = 0; i < NSUBEXP; ++i) {
+    if (2 * i < slots) {
+      this->StartP[i] = found[2 * i];
+      this->EndP[i] = found[2 * i + 1];
+    } else {
+      this->StartP[i] = this->EndP[i] = 0;
+    }
+  }
+  return true;
+}
+
+bool cmRegularExpression::FindBacktrack(const char* s, size_t length,
+                                        const char** found)
+{
+  typedef cmRegularExpressionProgram P;
+  P const& program = *this->Program;
+  int const slots = program.Slots;
+  size_t const stride = length + 1;
+  this->Visited.assign(
+    (program.Joins * stride + BitsPerWord - 1) / BitsPerWord, 0);
+  std::fill(found, found + slots, static_cast<const char*>(0));
+
+  const char* start = s;
+  for (;;) {
+    if (program.FirstChar >= 0 &&
+        static_cast<unsigned char>(*start) != program.FirstChar) {
+      start = strchr(start, static_cast<char>(program.FirstChar));
+      if (!start) {
+        return false;
+      }
+    }
+
+    // Try alternatives in the order a backtracking matcher would.  A
+    // state seen before failed already, whatever the captures were.
+    this->Jobs.clear();
+    BacktrackJob job = { 0, -1, start };
+    this->Jobs.push_back(job);
+    while (!this->Jobs.empty()) {
+      job = this->Jobs.back();
+      this->Jobs.pop_back();
+      if (job.Slot >= 0) {
+        found[job.Slot] = job.Position;
+        continue;
+      }
+      int pc = job.Pc;
+      const char* sp = job.Position;
+      for (;;) {
+        int const join = program.JoinIndex[pc];
+        if (join >= 0) {
+          size_t const bit = static_cast<size_t>(join) * stride +
+            static_cast<size_t>(sp - s);
+          unsigned int const mask = 1u << (bit % BitsPerWord);
+          unsigned int& word = this->Visited[bit / BitsPerWord];
+          if (word & mask) {
+            break;
+          }
+          word |= mask;
+        }
+
+        P::Instruction const& instruction = program.Code[pc];
+        unsigned char const c = static_cast<unsigned char>(*sp);
+        bool next = true;
+        switch (instruction.Op) {
+          case P::Char:
+            next = c != '\0' && c == instruction.X;
+            ++sp;
+            break;
+          case P::Any:
+            next = c != '\0';
+            ++sp;
+            break;
+          case P::Class:
+            next = c != '\0' && program.Classes[instruction.X].test(c);
+            ++sp;
+            break;
+          case P::Bol:
+            next = sp == s;
+            break;
+          case P::Eol:
+            next = c == '\0';
+            break;
+          case P::Save: {
+            BacktrackJob restore = { 0, instruction.X,
+                                     found[instruction.X] };
+            this->Jobs.push_back(restore);
+            found[instruction.X] = sp;
+          } break;
+          case P::Split: {
+            BacktrackJob alternative = { instruction.Y, -1, sp };
+            this->Jobs.push_back(alternative);
+            pc = instruction.X;
+            continue;
+          }
+          case P::Jump:
+            pc = instruction.X;
+            continue;
+          case P::Match:
+            return true;
+        }
+        if (!next) {
+          break;
+        }
+        ++pc;
+      }
+    }
+
+    if (program.Anchored || *start == '\0') {
+      return false;
+    }
+    ++start;
+  }
+}
+
+bool cmRegularExpression::FindParallel(const char* s, const char** found)
+{
+  typedef cmRegularExpressionProgram P;
+  P const& program = *this->Program;
+  int const slots = program.Slots;
+
+  size_t const size = program.Code.size();
+  for (int l = 0; l < 2; ++l) {
+    ThreadList& list = this->Lists[l];
+    if (list.Pcs.size() != size || list.Captures.size() != size * slots) {
+      list.Pcs.resize(size);
+      list.Marks.assign(size, 0);
+      list.Captures.resize(size * slots);
+      list.Generation = 0;
+    }
+  }
+
+  const char* captures[2 * NSUBEXP];
+  bool matched = false;
+  ThreadList* current = &this->Lists[0];
+  ThreadList* next = &this->Lists[1];
+  this->ResetList(*current);
+  const char* sp = s;
+  for (;;) {
+    // Start a new thread at each position, with lower priority than the
+    // threads that started earlier, until a match is found.
+    if (!matched && (!program.Anchored || sp == s)) {
+      if (current->Size == 0 && program.FirstChar >= 0 &&
+          static_cast<unsigned char>(*sp) != program.FirstChar) {
+        sp = strchr(sp, static_cast<char>(program.FirstChar));
+        if (!sp) {
+          break;
+        }
+      }
+      std::fill(captures, captures + slots, static_cast<const char*>(0));
+      this->AddThread(*current, 0, captures, sp);
+    }
+    if (current->Size == 0) {
+      if (matched || program.Anchored || *sp == '\0') {
+        break;
+      }
+      this->ResetList(*current);
+      ++sp;
+      continue;
+    }
+
+    unsigned char const c = static_cast<unsigned char>(*sp);
+    this->ResetList(*next);
+    for (size_t t = 0; t < current->Size; ++t) {
+      P::Instruction const& instruction = program.Code[current->Pcs[t]];
+      const char** threadCaptures = &current->Captures[t * slots];
+      bool advance = false;
+      switch (instruction.Op) {
+        case P::Char:
+          advance = c != '\0' && c == instruction.X;
+          break;
+        case P::Any:
+          advance = c != '\0';
+          break;
+        case P::Class:
+          advance = c != '\0' && program.Classes[instruction.X].test(c);
+          break;
+        case P::Match:
+          // Threads with lower priority cannot produce the match a
+          // backtracking matcher would report.
+          matched = true;
+          std::copy(threadCaptures, threadCaptures + slots, found);
+          t = current->Size;
+          break;
+        default:
+          break;
+      }
+      if (advance) {
+        this->AddThread(*next, current->Pcs[t] + 1, threadCaptures, sp + 1);
+      }
+    }
+    if (c == '\0') {
+      break;
+    }
+    std::swap(current, next);
+    ++sp;
+  }
+  return matched;
+}
+
+std::string cmRegularExpression::match(int n) const
+{
+  if (this->StartP[n] == 0) {
+    return std::string();
+  }
+  return std::string(
+    this->StartP[n],
+    static_cast<std::string::size_type>(this->EndP[n] - this->StartP[n]));
+}
@@ -0,0 +1,112 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmRegularExpression_h
+#define cmRegularExpression_h
+
+#include "cmStandardIncludes.h"
+
+class cmRegularExpressionProgram;
+
+/** \class cmRegularExpression
+ * \brief Regular expression matching for the CMake language.
+ *
+ * This accepts exactly the syntax of cmsys::RegularExpression and finds
+ * the same matches and subexpressions, but compiled expressions are
+ * shared through a cache keyed by the pattern text, and matching
+ * simulates all alternatives at once in time linear in the length of
+ * the input instead of backtracking.
+ */
+class cmRegularExpression
+{
+public:
+  enum
+  {
+    NSUBEXP = 10
+  };
+
+  cmRegularExpression();
+  explicit cmRegularExpression(std::string const& pattern);
+  ~cmRegularExpression();
+
+  /** Compile a pattern.  Returns false and reports the error as
+      cmsys::RegularExpression does if the pattern is invalid.  */
+  bool compile(std::string const& pattern);
+
+  /** Whether a pattern has been compiled successfully.  */
+  bool is_valid() const { return this->Program != 0; }
+
+  /** Find the leftmost match in a string.  */
+  bool find(const char* s);
+  bool find(std::string const& s) { return this->find(s.c_str()); }
+
+  /** Offsets of the whole match or of a subexpression in the string
+      given to the last successful find.  */
+  std::string::size_type start(int n = 0) const
+  {
+    return static_cast<std::string::size_type>(this->StartP[n] -
+                                               this->SearchString);
+  }
+  std::string::size_type end(int n = 0) const
+  {
+    return static_cast<std::string::size_type>(this->EndP[n] -
+                                               this->SearchString);
+  }
+
+  /** Text of the whole match or of a subexpression, or an empty string
+      if the subexpression did not participate in the match.  */
+  std::string match(int n) const;
+
+private:
+  cmRegularExpression(cmRegularExpression const&);
+  cmRegularExpression& operator=(cmRegularExpression const&);
+
+  void Release();
+
+  cmRegularExpressionProgram* Program;
+  const char* StartP[NSUBEXP];
+  const char* EndP[NSUBEXP];
+  const char* SearchString;
+
+  bool FindBacktrack(const char* s, size_t length, const char** found);
+  bool FindParallel(const char* s, const char** found);
+
+  // Backtracking state reused across calls to find.  A job with a
+  // capture slot restores it, and otherwise resumes at an instruction.
+  struct BacktrackJob
+  {
+    int Pc;
+    int Slot;
+    const char* Position;
+  };
+  enum
+  {
+    BitsPerWord = 32
+  };
+  std::vector<unsigned int> Visited;
+  std::vector<BacktrackJob> Jobs;
+
+  // Thread lists reused across calls to find.
+  struct ThreadList
+  {
+    std::vector<int> Pcs;
+    std::vector<unsigned int> Marks;
+    std::vector<const char*> Captures;
+    unsigned int Generation;
+    size_t Size;
+  };
+  ThreadList Lists[2];
+  void ResetList(ThreadList& list);
+  void AddThread(ThreadList& list, int pc, const char** captures,
+                 const char* sp);
+};
+
+#endif
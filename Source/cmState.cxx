@@ -95,7 +95,8 @@ struct cmState::BuildsystemDirectoryStateType
 };
 
 cmState::cmState()
-  : IsInTryCompile(false)
+  : ReleasedVarScopes(0)
+  , IsInTryCompile(false)
   , WindowsShell(false)
   , WindowsVSIDE(false)
   , WatcomWMake(false)
@@ -326,6 +327,7 @@ cmState::Snapshot cmState::Reset()
     std::string binDir =
       cmDefinitions::Get("CMAKE_BINARY_DIR", pos->Vars, pos->Root);
     this->VarTree.Clear();
+    this->ReleasedVarScopes = 0;
     pos->Vars = this->VarTree.Push(this->VarTree.Root());
     pos->Parent = this->VarTree.Root();
     pos->Root = this->VarTree.Root();
@@ -922,11 +924,31 @@ cmState::Snapshot cmState::Pop(cmState::Snapshot originSnapshot)
       this->ExecutionListFiles.Pop(pos->ExecutionListFile);
     }
     this->SnapshotData.Pop(pos);
+  } else if (!pos->Keep && pos->Vars != prevPos->Vars) {
+    // A snapshot kept for an include() or add_subdirectory() within this
+    // scope still follows it, so its storage cannot be dropped.  Nothing
+    // looks up variables in a scope that has been left, so release them.
+    *pos->Vars = cmDefinitions();
+    ++this->ReleasedVarScopes;
   }
 
   return Snapshot(this, prevPos);
 }
 
+void cmState::PrintStorageStatistics(std::ostream& os) const
+{
+  /* clang-format off */
+  os << "State storage:\n"
+     << "  snapshots: " << this->SnapshotData.Size() << "\n"
+     << "  variable scopes: " << this->VarTree.Size()
+     << " (" << this->ReleasedVarScopes << " released)\n"
+     << "  policy stack entries: " << this->PolicyStack.Size() << "\n"
+     << "  list file stack entries: " << this->ExecutionListFiles.Size()
+     << "\n"
+     << "  directories: " << this->BuildsystemDirectory.Size() << "\n";
+  /* clang-format on */
+}
+
 cmState::Snapshot::Snapshot(cmState* state)
   : State(state)
   , Position()
@@ -1024,7 +1046,7 @@ void cmState::Directory::SetRelativePathTopBinary(const char* dir)
   this->DirectoryState->RelativePathTopBinary = dir;
 }
 
-std::string cmState::Snapshot::GetExecutionListFile() const
+std::string const& cmState::Snapshot::GetExecutionListFile() const
 {
   return *this->Position->ExecutionListFile;
 }
@@ -1175,6 +1197,14 @@ const char* cmState::Snapshot::GetDefinition(std::string const& name) const
   return cmDefinitions::Get(name, this->Position->Vars, this->Position->Root);
 }
 
+std::vector<std::string> const* cmState::Snapshot::GetDefinitionList(
+  std::string const& name) const
+{
+  assert(this->Position->Vars.IsValid());
+  return cmDefinitions::GetList(name, this->Position->Vars,
+                                this->Position->Root);
+}
+
 bool cmState::Snapshot::IsInitialized(std::string const& name) const
 {
   return cmDefinitions::HasKey(name, this->Position->Vars,
@@ -1192,6 +1222,13 @@ void cmState::Snapshot::RemoveDefinition(std::string const& name)
   this->Position->Vars->Set(name, 0);
 }
 
+bool cmState::Snapshot::AppendDefinition(
+  std::string const& name, std::vector<std::string> const& values)
+{
+  return cmDefinitions::Append(name, values, this->Position->Vars,
+                               this->Position->Root);
+}
+
 std::vector<std::string> cmState::Snapshot::UnusedKeys() const
 {
   return this->Position->Vars->UnusedKeys();
@@ -59,16 +59,20 @@ public:
     Snapshot(cmState* state, PositionType position);
 
     const char* GetDefinition(std::string const& name) const;
+    std::vector<std::string> const* GetDefinitionList(
+      std::string const& name) const;
     bool IsInitialized(std::string const& name) const;
     void SetDefinition(std::string const& name, std::string const& value);
     void RemoveDefinition(std::string const& name);
+    bool AppendDefinition(std::string const& name,
+                          std::vector<std::string> const& values);
     std::vector<std::string> UnusedKeys() const;
     std::vector<std::string> ClosureKeys() const;
     bool RaiseScope(std::string const& var, const char* varDef);
 
     void SetListFile(std::string const& listfile);
 
-    std::string GetExecutionListFile() const;
+    std::string const& GetExecutionListFile() const;
 
     std::vector<Snapshot> GetChildren();
 
@@ -211,6 +215,9 @@ public:
   Snapshot CreatePolicyScopeSnapshot(Snapshot originSnapshot);
   Snapshot Pop(Snapshot originSnapshot);
 
+  /** Print how many snapshots and scopes of each kind are stored.  */
+  void PrintStorageStatistics(std::ostream& os) const;
+
   enum CacheEntryType
   {
     BOOL = 0,
@@ -342,6 +349,7 @@ private:
   cmLinkedTree<PolicyStackEntry> PolicyStack;
   cmLinkedTree<SnapshotDataType> SnapshotData;
   cmLinkedTree<cmDefinitions> VarTree;
+  size_t ReleasedVarScopes;
 
   std::vector<std::string> SourceDirectoryComponents;
   std::vector<std::string> BinaryDirectoryComponents;
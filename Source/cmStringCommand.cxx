@@ -12,8 +12,8 @@
 #include "cmStringCommand.h"
 
 #include "cmCryptoHash.h"
+#include "cmRegularExpression.h"
 
-#include <cmsys/RegularExpression.hxx>
 #include <cmsys/SystemTools.hxx>
 
 #include <ctype.h>
@@ -233,8 +233,8 @@ bool cmStringCommand::RegexMatch(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  cmRegularExpression re;
+  if (!re.compile(regex)) {
     std::string e =
       "sub-command REGEX, mode MATCH failed to compile regex \"" + regex +
       "\".";
@@ -274,8 +274,8 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  cmRegularExpression re;
+  if (!re.compile(regex)) {
     std::string e =
       "sub-command REGEX, mode MATCHALL failed to compile regex \"" + regex +
       "\".";
@@ -356,8 +356,8 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  cmRegularExpression re;
+  if (!re.compile(regex)) {
     std::string e =
       "sub-command REGEX, mode REPLACE failed to compile regex \"" + regex +
       "\".";
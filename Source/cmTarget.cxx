@@ -130,6 +130,7 @@ void cmTarget::SetMakefile(cmMakefile* mf)
     this->SetPropertyDefault("AUTOMOC_MOC_OPTIONS", 0);
     this->SetPropertyDefault("AUTOUIC_OPTIONS", 0);
     this->SetPropertyDefault("AUTORCC_OPTIONS", 0);
+    this->SetPropertyDefault("AUTOGEN_PARALLEL", 0);
     this->SetPropertyDefault("LINK_DEPENDS_NO_SHARED", 0);
     this->SetPropertyDefault("LINK_INTERFACE_LIBRARIES", 0);
     this->SetPropertyDefault("WIN32_EXECUTABLE", 0);
@@ -16,6 +16,7 @@
 #include "cmOutputConverter.h"
 #include "cmSystemTools.h"
 #include "cmTest.h"
+#include "cmTestManifest.h"
 
 cmTestGenerator::cmTestGenerator(
   cmTest* test, std::vector<std::string> const& configurations)
@@ -64,12 +65,40 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
 {
   this->TestGenerated = true;
 
+  // Start the test command.
+  os << indent << "add_test(" << this->Test->GetName();
+
+  // Generate the command line with full escapes.
+  std::vector<std::string> command;
+  this->ComputeCommand(config, command);
+  for (std::vector<std::string>::const_iterator ci = command.begin();
+       ci != command.end(); ++ci) {
+    os << " " << cmOutputConverter::EscapeForCMake(*ci);
+  }
+
+  // Finish the test command.
+  os << ")\n";
+
+  // Output properties for the test.
+  std::vector<std::string> properties;
+  this->ComputeProperties(config, properties);
+  if (!properties.empty()) {
+    os << indent << "set_tests_properties(" << this->Test->GetName()
+       << " PROPERTIES ";
+    for (std::vector<std::string>::const_iterator pi = properties.begin();
+         pi != properties.end(); pi += 2) {
+      os << " " << *pi << " " << cmOutputConverter::EscapeForCMake(pi[1]);
+    }
+    os << ")" << std::endl;
+  }
+}
+
+void cmTestGenerator::ComputeCommand(const std::string& config,
+                                     std::vector<std::string>& argv)
+{
   // Set up generator expression evaluation context.
   cmGeneratorExpression ge(this->Test->GetBacktrace());
 
-  // Start the test command.
-  os << indent << "add_test(" << this->Test->GetName() << " ";
-
   // Get the test command line to be executed.
   std::vector<std::string> const& command = this->Test->GetCommand();
 
@@ -88,12 +117,9 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
       cmSystemTools::ExpandListArgument(emulator, emulatorWithArgs);
       std::string emulatorExe(emulatorWithArgs[0]);
       cmSystemTools::ConvertToUnixSlashes(emulatorExe);
-      os << cmOutputConverter::EscapeForCMake(emulatorExe) << " ";
-      for (std::vector<std::string>::const_iterator ei =
-             emulatorWithArgs.begin() + 1;
-           ei != emulatorWithArgs.end(); ++ei) {
-        os << cmOutputConverter::EscapeForCMake(*ei) << " ";
-      }
+      argv.push_back(emulatorExe);
+      argv.insert(argv.end(), emulatorWithArgs.begin() + 1,
+                  emulatorWithArgs.end());
     }
   } else {
     // Use the command name given.
@@ -101,29 +127,121 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
     cmSystemTools::ConvertToUnixSlashes(exe);
   }
 
-  // Generate the command line with full escapes.
-  os << cmOutputConverter::EscapeForCMake(exe);
+  argv.push_back(exe);
   for (std::vector<std::string>::const_iterator ci = command.begin() + 1;
        ci != command.end(); ++ci) {
-    os << " " << cmOutputConverter::EscapeForCMake(
-                   ge.Parse(*ci)->Evaluate(this->LG, config));
+    argv.push_back(ge.Parse(*ci)->Evaluate(this->LG, config));
   }
+}
 
-  // Finish the test command.
-  os << ")\n";
-
-  // Output properties for the test.
+void cmTestGenerator::ComputeProperties(const std::string& config,
+                                        std::vector<std::string>& props)
+{
+  cmGeneratorExpression ge(this->Test->GetBacktrace());
   cmPropertyMap& pm = this->Test->GetProperties();
-  if (!pm.empty()) {
-    os << indent << "set_tests_properties(" << this->Test->GetName()
-       << " PROPERTIES ";
+  for (cmPropertyMap::const_iterator i = pm.begin(); i != pm.end(); ++i) {
+    props.push_back(i->first);
+    props.push_back(
+      ge.Parse(i->second.GetValue())->Evaluate(this->LG, config));
+  }
+}
+
+static void cmTestGeneratorWriteManifestTest(
+  std::ostream& os, const char* mode, std::vector<std::string> const& configs,
+  std::vector<std::string> const& args,
+  std::vector<std::string> const& properties)
+{
+  std::vector<std::string> fields;
+  fields.push_back(mode);
+  std::ostringstream nconfigs;
+  nconfigs << configs.size();
+  fields.push_back(nconfigs.str());
+  fields.insert(fields.end(), configs.begin(), configs.end());
+  std::ostringstream nargs;
+  nargs << args.size();
+  fields.push_back(nargs.str());
+  fields.insert(fields.end(), args.begin(), args.end());
+  fields.insert(fields.end(), properties.begin(), properties.end());
+  cmTestManifest::WriteRecord(os, "test", fields);
+}
+
+bool cmTestGenerator::GenerateManifest(
+  std::ostream& os, const std::string& config,
+  std::vector<std::string> const& configurationTypes)
+{
+  // The test name is written unquoted into the script, so anything the
+  // CMake language parser would reinterpret cannot be represented.
+  std::string const& name = this->Test->GetName();
+  if (name.empty() || name.find_first_of(" \t\r\n\"\\$#();") != name.npos) {
+    return false;
+  }
+
+  // Tests apply to the configurations they were restricted to, or to
+  // all configurations when no restriction was given.
+  const char* mode = this->Configurations.empty() ? "*" : "=";
+
+  if (!this->ActionsPerConfig) {
+    // Old-style test arguments are double-quoted into the script and
+    // re-parsed at test time, so variable references and escapes in
+    // them need the interpreter.
+    std::vector<std::string> args = this->Test->GetCommand();
+    cmSystemTools::ConvertToUnixSlashes(args[0]);
+    for (std::vector<std::string>::const_iterator ai = args.begin();
+         ai != args.end(); ++ai) {
+      if (ai->find_first_of("\\$") != ai->npos ||
+          (ai == args.begin() && ai->find('"') != ai->npos)) {
+        return false;
+      }
+    }
+    args.insert(args.begin(), name);
+    std::vector<std::string> properties;
+    cmPropertyMap& pm = this->Test->GetProperties();
     for (cmPropertyMap::const_iterator i = pm.begin(); i != pm.end(); ++i) {
-      os << " " << i->first << " "
-         << cmOutputConverter::EscapeForCMake(
-              ge.Parse(i->second.GetValue())->Evaluate(this->LG, config));
+      properties.push_back(i->first);
+      properties.push_back(i->second.GetValue());
     }
-    os << ")" << std::endl;
+    cmTestGeneratorWriteManifestTest(os, mode, this->Configurations, args,
+                                     properties);
+    return true;
+  }
+
+  if (configurationTypes.empty()) {
+    // Single-configuration generator: one entry for the configuration
+    // built in the tree.
+    std::vector<std::string> args(1, name);
+    this->ComputeCommand(config, args);
+    std::vector<std::string> properties;
+    this->ComputeProperties(config, properties);
+    cmTestGeneratorWriteManifestTest(os, mode, this->Configurations, args,
+                                     properties);
+    return true;
+  }
+
+  // Multi-configuration generator: one entry per configuration built,
+  // plus a placeholder for any other configuration requested at test
+  // time if the test is not restricted to particular configurations.
+  std::vector<std::string> generated;
+  for (std::vector<std::string>::const_iterator ci =
+         configurationTypes.begin();
+       ci != configurationTypes.end(); ++ci) {
+    if (!this->GeneratesForConfig(*ci)) {
+      continue;
+    }
+    std::vector<std::string> args(1, name);
+    this->ComputeCommand(*ci, args);
+    std::vector<std::string> properties;
+    this->ComputeProperties(*ci, properties);
+    cmTestGeneratorWriteManifestTest(os, "=", std::vector<std::string>(1, *ci),
+                                     args, properties);
+    generated.push_back(*ci);
+  }
+  if (!generated.empty() && this->Configurations.empty()) {
+    std::vector<std::string> args(1, name);
+    args.push_back("NOT_AVAILABLE");
+    cmTestGeneratorWriteManifestTest(os, "!", generated, args,
+                                     std::vector<std::string>());
   }
+  return true;
 }
 
 void cmTestGenerator::GenerateScriptNoConfig(std::ostream& os,
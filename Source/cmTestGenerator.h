@@ -31,6 +31,12 @@ public:
 
   void Compute(cmLocalGenerator* lg);
 
+  /** Write the manifest entries of this test for ctest to load without
+      evaluating the generated script.  Returns false if the test cannot
+      be represented in the manifest.  */
+  bool GenerateManifest(std::ostream& os, const std::string& config,
+                        std::vector<std::string> const& configurationTypes);
+
 protected:
   virtual void GenerateScriptConfigs(std::ostream& os, Indent const& indent);
   virtual void GenerateScriptActions(std::ostream& os, Indent const& indent);
@@ -41,6 +47,11 @@ protected:
   virtual bool NeedsScriptNoConfig() const;
   void GenerateOldStyle(std::ostream& os, Indent const& indent);
 
+  void ComputeCommand(const std::string& config,
+                      std::vector<std::string>& argv);
+  void ComputeProperties(const std::string& config,
+                         std::vector<std::string>& props);
+
   cmLocalGenerator* LG;
   cmTest* Test;
   bool TestGenerated;
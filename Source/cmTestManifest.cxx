@@ -0,0 +1,92 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmTestManifest.h"
+
+#include <cmsys/FStream.hxx>
+
+#include <stdlib.h>
+
+const char* cmTestManifest::FileName()
+{
+  return "CTestTestfile.manifest";
+}
+
+const char* cmTestManifest::Version()
+{
+  return "1";
+}
+
+void cmTestManifest::WriteHeader(std::ostream& os)
+{
+  std::vector<std::string> fields;
+  fields.push_back(cmTestManifest::Version());
+  cmTestManifest::WriteRecord(os, "ctest-manifest", fields);
+}
+
+void cmTestManifest::WriteRecord(std::ostream& os, const char* keyword,
+                                 std::vector<std::string> const& fields)
+{
+  os << keyword;
+  for (std::vector<std::string>::const_iterator fi = fields.begin();
+       fi != fields.end(); ++fi) {
+    os << " " << fi->size() << ":" << *fi;
+  }
+  os << "\n";
+}
+
+bool cmTestManifest::Read(std::string const& fname,
+                          std::vector<Record>& records)
+{
+  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::string content;
+  char buffer[16384];
+  while (fin) {
+    fin.read(buffer, sizeof(buffer));
+    content.append(buffer, static_cast<size_t>(fin.gcount()));
+  }
+
+  const char* p = content.c_str();
+  const char* end = p + content.size();
+  while (p != end) {
+    Record record;
+    const char* k = p;
+    while (p != end && *p != ' ' && *p != '\n') {
+      ++p;
+    }
+    record.Keyword.assign(k, p);
+    while (p != end && *p == ' ') {
+      ++p;
+      char* colon;
+      unsigned long len = strtoul(p, &colon, 10);
+      if (colon == p || colon == end || *colon != ':' ||
+          len > static_cast<unsigned long>(end - colon - 1)) {
+        return false;
+      }
+      p = colon + 1;
+      record.Fields.push_back(std::string(p, len));
+      p += len;
+    }
+    if (p == end || *p != '\n') {
+      return false;
+    }
+    ++p;
+    records.push_back(record);
+  }
+
+  // The first record identifies the format.
+  return (!records.empty() && records[0].Keyword == "ctest-manifest" &&
+          records[0].Fields.size() == 1 &&
+          records[0].Fields[0] == cmTestManifest::Version());
+}
@@ -0,0 +1,52 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmTestManifest_h
+#define cmTestManifest_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmTestManifest
+ * \brief Read and write the precompiled test list of a build directory.
+ *
+ * The manifest is written next to each CTestTestfile.cmake and holds
+ * the same information in a form that ctest can load without running
+ * the CMake language interpreter.  It is a sequence of records, one per
+ * line, each consisting of a keyword followed by length-prefixed
+ * fields so that arbitrary values need no escaping:
+ *
+ *   <keyword> <len>:<bytes> <len>:<bytes>...\n
+ */
+class cmTestManifest
+{
+public:
+  /** Name of the manifest file in each build directory.  */
+  static const char* FileName();
+
+  /** Version written in the header record.  */
+  static const char* Version();
+
+  struct Record
+  {
+    std::string Keyword;
+    std::vector<std::string> Fields;
+  };
+
+  static void WriteHeader(std::ostream& os);
+  static void WriteRecord(std::ostream& os, const char* keyword,
+                          std::vector<std::string> const& fields);
+
+  /** Load all records of a manifest file.  Returns false if the file
+      cannot be read, is malformed, or has an unknown version.  */
+  static bool Read(std::string const& fname, std::vector<Record>& records);
+};
+
+#endif
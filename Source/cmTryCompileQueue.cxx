@@ -0,0 +1,245 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmTryCompileQueue.h"
+
+#include "cmMakefile.h"
+#include "cmSystemTools.h"
+#include "cmake.h"
+
+#include <cmsys/Process.h>
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#include "cmMakefileProfilingData.h"
+#include <cmsys/SystemInformation.hxx>
+#endif
+
+// A running check and the process of its current command.
+struct cmTryCompileQueueRun
+{
+  cmTryCompileQueue::Job* Job;
+  size_t Command;
+  cmsysProcess* Process;
+};
+
+static unsigned int cmTryCompileQueueParallelLevel()
+{
+  unsigned int level = 1;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmsys::SystemInformation info;
+  info.RunCPUCheck();
+  if (info.GetNumberOfLogicalCPU() > 1) {
+    level = info.GetNumberOfLogicalCPU();
+  }
+#endif
+  return level;
+}
+
+// Start the current command of a check.  Returns false if it could not
+// be started, in which case the check is finished.
+static bool cmTryCompileQueueStart(cmTryCompileQueueRun& run)
+{
+  cmTryCompileQueue::Job& job = *run.Job;
+  std::vector<std::string> const& command = job.Commands[run.Command];
+  job.Output += "\nRun Build Command:";
+  job.Output += cmSystemTools::PrintSingleCommand(command);
+  job.Output += "\n";
+
+  std::vector<const char*> argv;
+  for (std::vector<std::string>::const_iterator ai = command.begin();
+       ai != command.end(); ++ai) {
+    argv.push_back(ai->c_str());
+  }
+  argv.push_back(0);
+
+  run.Process = cmsysProcess_New();
+  cmsysProcess_SetCommand(run.Process, &*argv.begin());
+  cmsysProcess_SetWorkingDirectory(run.Process, job.Directory.c_str());
+  cmsysProcess_SetOption(run.Process, cmsysProcess_Option_HideWindow, 1);
+  cmsysProcess_SetOption(run.Process, cmsysProcess_Option_MergeOutput, 1);
+  cmsysProcess_Execute(run.Process);
+  if (cmsysProcess_GetState(run.Process) == cmsysProcess_State_Error) {
+    job.Output += cmsysProcess_GetErrorString(run.Process);
+    job.Output += "\n";
+    job.Result = 1;
+    cmsysProcess_Delete(run.Process);
+    run.Process = 0;
+    return false;
+  }
+  return true;
+}
+
+// Collect output of the current command of a check.  Returns true while
+// it is still running.
+static bool cmTryCompileQueuePoll(cmTryCompileQueueRun& run, double timeout)
+{
+  cmTryCompileQueue::Job& job = *run.Job;
+  char* data;
+  int length;
+  int pipe;
+  while ((pipe = cmsysProcess_WaitForData(run.Process, &data, &length,
+                                          &timeout)) != 0 &&
+         pipe != cmsysProcess_Pipe_Timeout) {
+    for (int i = 0; i < length; ++i) {
+      if (data[i] == '\0') {
+        data[i] = ' ';
+      }
+    }
+    job.Output.append(data, length);
+  }
+  if (pipe == cmsysProcess_Pipe_Timeout) {
+    return true;
+  }
+
+  cmsysProcess_WaitForExit(run.Process, 0);
+  switch (cmsysProcess_GetState(run.Process)) {
+    case cmsysProcess_State_Exited:
+      job.Result = cmsysProcess_GetExitValue(run.Process);
+      break;
+    case cmsysProcess_State_Exception:
+      job.Output += cmsysProcess_GetExceptionString(run.Process);
+      job.Output += "\n";
+      job.Result = 1;
+      break;
+    default:
+      job.Output += cmsysProcess_GetErrorString(run.Process);
+      job.Output += "\n";
+      job.Result = 1;
+      break;
+  }
+  cmsysProcess_Delete(run.Process);
+  run.Process = 0;
+  return false;
+}
+
+void cmTryCompileQueue::Submit(Job const& job)
+{
+  this->Jobs.push_back(job);
+}
+
+void cmTryCompileQueue::Wait()
+{
+  if (this->Jobs.empty()) {
+    return;
+  }
+
+  // Callbacks may submit more checks.  Those belong to a later wait.
+  std::vector<Job> jobs;
+  jobs.swap(this->Jobs);
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmMakefileProfilingData* profiling =
+    jobs.front().Makefile->GetCMakeInstance()->GetProfilingOutput();
+  if (profiling) {
+    std::ostringstream name;
+    name << "try_compile queue (" << jobs.size() << " checks)";
+    profiling->StartEntry("cmake.try_compile", name.str());
+  }
+#endif
+
+  size_t const parallelLevel = cmTryCompileQueueParallelLevel();
+  std::vector<cmTryCompileQueueRun> running;
+  size_t next = 0;
+  while (next < jobs.size() || !running.empty()) {
+    while (running.size() < parallelLevel && next < jobs.size()) {
+      Job& job = jobs[next++];
+      job.Output = "Change Dir: ";
+      job.Output += job.Directory;
+      job.Output += "\n";
+      cmTryCompileQueueRun run;
+      run.Job = &job;
+      run.Command = 0;
+      run.Process = 0;
+      if (!job.Commands.empty() && cmTryCompileQueueStart(run)) {
+        running.push_back(run);
+      }
+    }
+
+    // Poll each running command briefly.  A check whose command finished
+    // successfully moves on to its next command.
+    double const timeout = 0.01;
+    for (size_t ri = 0; ri < running.size();) {
+      cmTryCompileQueueRun& run = running[ri];
+      if (cmTryCompileQueuePoll(run, timeout)) {
+        ++ri;
+      } else if (run.Job->Result == 0 &&
+                 ++run.Command < run.Job->Commands.size() &&
+                 cmTryCompileQueueStart(run)) {
+        ++ri;
+      } else {
+        running.erase(running.begin() + ri);
+      }
+    }
+  }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (profiling) {
+    profiling->StopEntry();
+  }
+#endif
+
+  for (std::vector<Job>::iterator ji = jobs.begin(); ji != jobs.end();
+       ++ji) {
+    StoreResult(*ji);
+  }
+}
+
+void cmTryCompileQueue::StoreResult(Job& job)
+{
+  cmMakefile* mf = job.Makefile;
+  mf->AddCacheDefinition(job.ResultVariable,
+                         (job.Result == 0 ? "TRUE" : "FALSE"),
+                         "Result of TRY_COMPILE", cmState::INTERNAL);
+  if (!job.OutputVariable.empty()) {
+    mf->AddDefinition(job.OutputVariable, job.Output.c_str());
+  }
+
+  std::string copyFileErrorMessage;
+  if (job.Result == 0 && !job.CopyFile.empty() &&
+      !cmSystemTools::CopyFileAlways(job.OutputFile, job.CopyFile)) {
+    std::ostringstream emsg;
+    /* clang-format off */
+    emsg << "Cannot copy output executable\n"
+         << "  '" << job.OutputFile << "'\n"
+         << "to destination specified by COPY_FILE:\n"
+         << "  '" << job.CopyFile << "'\n";
+    /* clang-format on */
+    if (job.CopyFileError.empty()) {
+      mf->IssueMessage(cmake::FATAL_ERROR, emsg.str());
+    } else {
+      copyFileErrorMessage = emsg.str();
+    }
+  }
+  if (!job.CopyFileError.empty()) {
+    mf->AddDefinition(job.CopyFileError, copyFileErrorMessage.c_str());
+  }
+
+  if (!mf->GetCMakeInstance()->GetDebugTryCompile()) {
+    cmSystemTools::RemoveADirectory(job.Directory);
+  }
+
+  if (!job.Callback.empty()) {
+    InvokeCallback(mf, job.Callback, job.Line);
+  }
+}
+
+bool cmTryCompileQueue::InvokeCallback(
+  cmMakefile* mf, std::vector<std::string> const& callback, long line)
+{
+  cmListFileFunction lff;
+  lff.Name = callback[0];
+  lff.Line = line;
+  for (std::vector<std::string>::const_iterator ai = callback.begin() + 1;
+       ai != callback.end(); ++ai) {
+    lff.Arguments.push_back(
+      cmListFileArgument(*ai, cmListFileArgument::Quoted, line));
+  }
+  cmExecutionStatus status;
+  return mf->ExecuteCommand(lff, status);
+}
@@ -0,0 +1,77 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmTryCompileQueue_h
+#define cmTryCompileQueue_h
+
+#include "cmStandardIncludes.h"
+
+class cmMakefile;
+
+/** \class cmTryCompileQueue
+ * \brief Run deferred try_compile checks concurrently.
+ *
+ * The commands of a check submitted with the DEFER option of try_compile
+ * are computed when it is submitted.  Waiting for the queue runs the
+ * commands of all queued checks in parallel, each check in its own
+ * scratch directory, and then stores the results in submission order.
+ */
+class cmTryCompileQueue
+{
+public:
+  struct Job
+  {
+    Job()
+      : Makefile(0)
+      , Line(0)
+      , Result(0)
+    {
+    }
+    cmMakefile* Makefile;
+    long Line;
+    std::string ResultVariable;
+    std::string OutputVariable;
+    std::string CopyFile;
+    std::string CopyFileError;
+    std::vector<std::string> Callback;
+
+    /** Scratch directory removed once the result is stored.  */
+    std::string Directory;
+    std::string OutputFile;
+    std::vector<std::vector<std::string> > Commands;
+
+    std::string Output;
+    int Result;
+  };
+
+  /** Queue a check.  */
+  void Submit(Job const& job);
+
+  /** Whether any check is waiting to run.  */
+  bool IsEmpty() const { return this->Jobs.empty(); }
+
+  /** Run all queued checks and store their results in the makefiles that
+      submitted them, in submission order.  */
+  void Wait();
+
+  /** Invoke the command named by the first element of a CALLBACK
+      option with the remaining elements as arguments.  */
+  static bool InvokeCallback(cmMakefile* mf,
+                             std::vector<std::string> const& callback,
+                             long line);
+
+private:
+  std::vector<Job> Jobs;
+
+  static void StoreResult(Job& job);
+};
+
+#endif
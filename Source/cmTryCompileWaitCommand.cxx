@@ -0,0 +1,28 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmTryCompileWaitCommand.h"
+
+#include "cmGlobalGenerator.h"
+#include "cmTryCompileQueue.h"
+
+// cmTryCompileWaitCommand
+bool cmTryCompileWaitCommand::InitialPass(std::vector<std::string> const& args,
+                                          cmExecutionStatus&)
+{
+  if (!args.empty()) {
+    this->SetError("called with incorrect number of arguments");
+    return false;
+  }
+
+  this->Makefile->GetGlobalGenerator()->GetTryCompileQueue()->Wait();
+  return true;
+}
@@ -0,0 +1,46 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmTryCompileWaitCommand_h
+#define cmTryCompileWaitCommand_h
+
+#include "cmCommand.h"
+
+/** \class cmTryCompileWaitCommand
+ * \brief Wait for deferred try_compile checks
+ *
+ * cmTryCompileWaitCommand runs the checks queued by try_compile with the
+ * DEFER option and stores their results.
+ */
+class cmTryCompileWaitCommand : public cmCommand
+{
+public:
+  /**
+   * This is a virtual constructor for the command.
+   */
+  virtual cmCommand* Clone() { return new cmTryCompileWaitCommand; }
+
+  /**
+   * This is called when the command is first encountered in
+   * the CMakeLists.txt file.
+   */
+  virtual bool InitialPass(std::vector<std::string> const& args,
+                           cmExecutionStatus& status);
+
+  /**
+   * The name of the command as specified in CMakeList.txt.
+   */
+  virtual std::string GetName() const { return "try_compile_wait"; }
+
+  cmTypeMacro(cmTryCompileWaitCommand, cmCommand);
+};
+
+#endif
@@ -113,21 +113,34 @@ bool cmTryRunCommand::InitialPass(std::vector<std::string> const& argv,
   this->CompileResultVariable = argv[1];
 
   // do the try compile
+  this->RunArgs = runArgs;
   int res = this->TryCompileCode(tryCompile, true);
 
   // now try running the command if it compiled
   if (!res) {
-    if (this->OutputFile.empty()) {
+    if (this->OutputFile.empty() && !this->CacheHit) {
       cmSystemTools::Error(this->FindErrorMessage.c_str());
     } else {
       // "run" it and capture the output
       std::string runOutputContents;
-      if (this->Makefile->IsOn("CMAKE_CROSSCOMPILING") &&
-          !this->Makefile->IsDefinitionSet("CMAKE_CROSSCOMPILING_EMULATOR")) {
+      if (this->CacheHit) {
+        runOutputContents = this->CacheEntry["run-output"];
+        this->Makefile->AddCacheDefinition(
+          this->RunResultVariable, this->CacheEntry["run-result"].c_str(),
+          "Result of TRY_RUN", cmState::INTERNAL);
+      } else if (this->Makefile->IsOn("CMAKE_CROSSCOMPILING") &&
+                 !this->Makefile->IsDefinitionSet(
+                   "CMAKE_CROSSCOMPILING_EMULATOR")) {
         this->DoNotRunExecutable(runArgs, argv[3],
                                  captureRunOutput ? &runOutputContents : 0);
       } else {
         this->RunExecutable(runArgs, &runOutputContents);
+        if (!this->CacheFile.empty()) {
+          this->CacheEntry["run-result"] =
+            this->Makefile->GetSafeDefinition(this->RunResultVariable);
+          this->CacheEntry["run-output"] = runOutputContents;
+          this->WriteCacheEntry();
+        }
       }
 
       // now put the output into the variables
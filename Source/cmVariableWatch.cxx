@@ -86,6 +86,11 @@ void cmVariableWatch::RemoveWatch(const std::string& variable,
   }
 }
 
+bool cmVariableWatch::IsWatched(const std::string& variable) const
+{
+  return this->WatchMap.find(variable) != this->WatchMap.end();
+}
+
 bool cmVariableWatch::VariableAccessed(const std::string& variable,
                                        int access_type, const char* newValue,
                                        const cmMakefile* mf) const
@@ -46,6 +46,11 @@ public:
   bool VariableAccessed(const std::string& variable, int access_type,
                         const char* newValue, const cmMakefile* mf) const;
 
+  /**
+   * Whether any watch is added to the variable.
+   */
+  bool IsWatched(const std::string& variable) const;
+
   /**
    * Different access types.
    */
@@ -17,6 +17,8 @@
 #include "cmDocumentationFormatter.h"
 #include "cmExternalMakefileProjectGenerator.h"
 #include "cmFileTimeComparison.h"
+#include "cmGeneratedFileStream.h"
+#include "cmGeneratorTarget.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSourceFile.h"
@@ -25,6 +27,7 @@
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #include "cmGraphVizWriter.h"
+#include "cmMakefileProfilingData.h"
 #include "cmVariableWatch.h"
 #include <cmsys/SystemInformation.hxx>
 #endif
@@ -123,6 +126,8 @@ cmake::cmake()
 {
   this->Trace = false;
   this->TraceExpand = false;
+  this->MemoryStats = false;
+  this->ProfilingOutput = 0;
   this->WarnUninitialized = false;
   this->WarnUnused = false;
   this->WarnUnusedCli = true;
@@ -196,6 +201,7 @@ cmake::~cmake()
   cmDeleteAll(this->Generators);
 #ifdef CMAKE_BUILD_WITH_CMAKE
   delete this->VariableWatch;
+  delete this->ProfilingOutput;
 #endif
   delete this->FileComparison;
 }
@@ -522,6 +528,8 @@ void cmake::SetArgs(const std::vector<std::string>& args,
   bool directoriesSet = directoriesSetBefore;
   bool haveToolset = false;
   bool havePlatform = false;
+  std::string profilingFormat;
+  std::string profilingOutput;
   for (unsigned int i = 1; i < args.size(); ++i) {
     std::string arg = args[i];
     if (arg.find("-H", 0) == 0) {
@@ -593,6 +601,21 @@ void cmake::SetArgs(const std::vector<std::string>& args,
       std::cout << "Running with trace output on.\n";
       this->SetTrace(true);
       this->SetTraceExpand(false);
+    } else if (arg.find("--memory-stats", 0) == 0) {
+      this->SetMemoryStats(true);
+    } else if (arg.find("--profiling-format=", 0) == 0) {
+      profilingFormat = arg.substr(strlen("--profiling-format="));
+      if (profilingFormat.empty()) {
+        cmSystemTools::Error("No format specified for --profiling-format");
+      }
+    } else if (arg.find("--profiling-output=", 0) == 0) {
+      profilingOutput = arg.substr(strlen("--profiling-output="));
+      if (profilingOutput.empty()) {
+        cmSystemTools::Error("No file specified for --profiling-output");
+      } else {
+        profilingOutput = cmSystemTools::CollapseFullPath(profilingOutput);
+        cmSystemTools::ConvertToUnixSlashes(profilingOutput);
+      }
     } else if (arg.find("--warn-uninitialized", 0) == 0) {
       std::cout << "Warn about uninitialized values.\n";
       this->SetWarnUninitialized(true);
@@ -669,6 +692,35 @@ void cmake::SetArgs(const std::vector<std::string>& args,
     this->SetHomeOutputDirectory(cmSystemTools::GetCurrentWorkingDirectory());
     this->SetHomeDirectory(cmSystemTools::GetCurrentWorkingDirectory());
   }
+
+  if (!profilingFormat.empty() || !profilingOutput.empty()) {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    if (profilingOutput.empty()) {
+      cmSystemTools::Error(
+        "--profiling-format specified but no --profiling-output");
+      return;
+    }
+    if (profilingFormat.empty()) {
+      cmSystemTools::Error(
+        "--profiling-output specified but no --profiling-format");
+      return;
+    }
+    if (profilingFormat != "google-trace") {
+      cmSystemTools::Error("Invalid format specified for --profiling-format");
+      return;
+    }
+    delete this->ProfilingOutput;
+    this->ProfilingOutput = new cmMakefileProfilingData(profilingOutput);
+    if (!this->ProfilingOutput->IsValid()) {
+      cmSystemTools::Error("Could not open profiling output file ",
+                           profilingOutput.c_str());
+      delete this->ProfilingOutput;
+      this->ProfilingOutput = 0;
+    }
+#else
+    cmSystemTools::Error("CMake was not built with support for profiling");
+#endif
+  }
 }
 
 void cmake::SetDirectoriesFromFile(const char* arg)
@@ -1464,15 +1516,73 @@ int cmake::Run(const std::vector<std::string>& args, bool noconfigure)
   return ret;
 }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+static void cmakeProfileGeneratedFile(const std::string& name,
+                                      unsigned long bytes, bool replaced,
+                                      void* clientData)
+{
+  cmMakefileProfilingData* profiling =
+    static_cast<cmMakefileProfilingData*>(clientData);
+  profiling->RecordGeneratedFile(name, bytes, replaced);
+}
+
+static void cmakeProfileGeneratorExpressions(
+  cmMakefileProfilingData* profiling, cmGlobalGenerator* gg)
+{
+  std::map<std::string, unsigned long> counts;
+  std::vector<cmLocalGenerator*> const& lgs = gg->GetLocalGenerators();
+  for (std::vector<cmLocalGenerator*>::const_iterator lgi = lgs.begin();
+       lgi != lgs.end(); ++lgi) {
+    std::vector<cmGeneratorTarget*> const& targets =
+      (*lgi)->GetGeneratorTargets();
+    for (std::vector<cmGeneratorTarget*>::const_iterator ti =
+           targets.begin();
+         ti != targets.end(); ++ti) {
+      if (unsigned long n = (*ti)->GetGeneratorExpressionEvaluations()) {
+        counts[(*ti)->GetName()] += n;
+      }
+    }
+  }
+  profiling->RecordGeneratorExpressionEvaluations(counts);
+}
+#endif
+
 int cmake::Generate()
 {
   if (!this->GlobalGenerator) {
     return -1;
   }
-  if (!this->GlobalGenerator->Compute()) {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmMakefileProfilingData* profiling = this->ProfilingOutput;
+  if (profiling) {
+    cmGeneratedFileStream::SetCloseCallback(cmakeProfileGeneratedFile,
+                                            profiling);
+  }
+#endif
+  bool computed;
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::Scope profilingScope(profiling, "cmake.generate",
+                                                  "Compute");
+#endif
+    computed = this->GlobalGenerator->Compute();
+  }
+  if (computed) {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    cmMakefileProfilingData::Scope profilingScope(profiling, "cmake.generate",
+                                                  "Generate");
+#endif
+    this->GlobalGenerator->Generate();
+  }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (profiling) {
+    cmGeneratedFileStream::SetCloseCallback(0);
+    cmakeProfileGeneratorExpressions(profiling, this->GlobalGenerator);
+  }
+#endif
+  if (!computed) {
     return -1;
   }
-  this->GlobalGenerator->Generate();
   if (!this->GraphVizFile.empty()) {
     std::cout << "Generate graphviz: " << this->GraphVizFile << std::endl;
     this->GenerateGraphViz(this->GraphVizFile.c_str());
@@ -25,6 +25,7 @@ class cmGlobalGeneratorFactory;
 class cmGlobalGenerator;
 class cmLocalGenerator;
 class cmMakefile;
+class cmMakefileProfilingData;
 class cmVariableWatch;
 class cmFileTimeComparison;
 class cmExternalMakefileProjectGenerator;
@@ -310,6 +311,15 @@ public:
   void SetTrace(bool b) { this->Trace = b; }
   bool GetTraceExpand() { return this->TraceExpand; }
   void SetTraceExpand(bool b) { this->TraceExpand = b; }
+  bool GetMemoryStats() const { return this->MemoryStats; }
+  void SetMemoryStats(bool b) { this->MemoryStats = b; }
+
+  /** The profile written for --profiling-output, or 0 if the configure
+      step is not profiled.  */
+  cmMakefileProfilingData* GetProfilingOutput() const
+  {
+    return this->ProfilingOutput;
+  }
   bool GetWarnUninitialized() { return this->WarnUninitialized; }
   void SetWarnUninitialized(bool b) { this->WarnUninitialized = b; }
   bool GetWarnUnused() { return this->WarnUnused; }
@@ -460,6 +470,8 @@ private:
   bool DebugOutput;
   bool Trace;
   bool TraceExpand;
+  bool MemoryStats;
+  cmMakefileProfilingData* ProfilingOutput;
   bool WarnUninitialized;
   bool WarnUnused;
   bool WarnUnusedCli;
@@ -73,6 +73,11 @@ static const char* cmDocumentationOptions[][2] = {
   { "--debug-output", "Put cmake in a debug mode." },
   { "--trace", "Put cmake in trace mode." },
   { "--trace-expand", "Put cmake in trace mode with variable expansion." },
+  { "--memory-stats", "Print how much state the configure step stores." },
+  { "--profiling-output=<file>",
+    "Write a profile of the configure step to the given file." },
+  { "--profiling-format=<fmt>",
+    "Format of the --profiling-output file.  Must be google-trace." },
   { "--warn-uninitialized", "Warn about uninitialized values." },
   { "--warn-unused-vars", "Warn about unused variables." },
   { "--no-warn-unused-cli", "Don't warn about command line options." },
@@ -0,0 +1,15 @@
+set(cost_data "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt")
+if(EXISTS "${cost_data}.journal")
+  set(RunCMake_TEST_FAILED "Cost journal not removed after run.")
+  return()
+endif()
+file(STRINGS "${cost_data}" lines)
+list(GET lines 0 test_line)
+list(GET lines 1 other_line)
+if(NOT test_line MATCHES "^CostJournal 5 800(\\.[0-9]+)? [0-9.e+]+$")
+  set(RunCMake_TEST_FAILED
+    "Journal not merged into statistics:\n  ${test_line}")
+elseif(NOT other_line STREQUAL "NotRun 2 3 0.5")
+  set(RunCMake_TEST_FAILED
+    "Statistics of other tests not preserved:\n  ${other_line}")
+endif()
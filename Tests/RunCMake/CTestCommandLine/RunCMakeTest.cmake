@@ -28,6 +28,44 @@ function(run_repeat_until_fail_tests)
 endfunction()
 run_repeat_until_fail_tests()
 
+function(run_TestManifest)
+  # Use a single build tree for a few tests without cleaning.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestManifest-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+
+  run_cmake(TestManifest-cmake)
+  run_cmake_command(TestManifest-ctest
+    ${CMAKE_CTEST_COMMAND} -C Debug -N -V
+    )
+
+  # Without a manifest in every directory ctest reads the scripts.
+  file(REMOVE "${RunCMake_TEST_BINARY_DIR}/TestManifest/CTestTestfile.manifest")
+  run_cmake_command(TestManifest-ctest-script
+    ${CMAKE_CTEST_COMMAND} -C Release -N -V
+    )
+endfunction()
+run_TestManifest()
+
+function(run_CostJournal)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CostJournal)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(CostJournal \"${CMAKE_COMMAND}\" -E echo CostJournal)
+")
+  # Statistics of an earlier run that did not complete.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt"
+    "CostJournal 1 1000 0\nNotRun 2 3 0.5\n---\n")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt.journal"
+    "CostJournal 4 1000 0\n")
+
+  run_cmake_command(CostJournal ${CMAKE_CTEST_COMMAND})
+endfunction()
+run_CostJournal()
+
 function(run_BadCTestTestfile)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/BadCTestTestfile)
   set(RunCMake_TEST_NO_CLEAN 1)
@@ -93,6 +131,23 @@ add_test(Echo \"${CMAKE_COMMAND}\" -E echo \"EchoTest\")
 endfunction()
 run_SerialFailed()
 
+function(run_ResourcePool)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ResourcePool)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(PoolTest1 \"${CMAKE_COMMAND}\" -E environment)
+add_test(PoolTest2 \"${CMAKE_COMMAND}\" -E environment)
+add_test(PoolTest3 \"${CMAKE_COMMAND}\" -E environment)
+set_tests_properties(PoolTest1 PoolTest2 PoolTest3 PROPERTIES
+  RESOURCE_POOL \"db:2;my-lock\")
+")
+
+  run_cmake_command(ResourcePool ${CMAKE_CTEST_COMMAND} -j3 -V)
+endfunction()
+run_ResourcePool()
+
 function(run_TestLoad name load)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestLoad)
   set(RunCMake_TEST_NO_CLEAN 1)
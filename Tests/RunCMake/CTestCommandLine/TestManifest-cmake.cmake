@@ -0,0 +1,9 @@
+enable_testing()
+
+add_test(NAME Top COMMAND ${CMAKE_COMMAND} -E echo top)
+set_tests_properties(Top PROPERTIES LABELS "a;b")
+add_test(TopOldStyle ${CMAKE_COMMAND} -E echo "old style")
+add_test(NAME DebugOnly CONFIGURATIONS Debug
+  COMMAND ${CMAKE_COMMAND} -E echo debug)
+
+add_subdirectory(TestManifest)
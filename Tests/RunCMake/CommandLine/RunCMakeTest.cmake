@@ -264,6 +264,18 @@ set(RunCMake_TEST_OPTIONS --trace-expand)
 run_cmake(trace-expand)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_OPTIONS --profiling-format=google-trace
+  --profiling-output=${RunCMake_BINARY_DIR}/profiling-build/profile.json)
+run_cmake(profiling)
+unset(RunCMake_TEST_OPTIONS)
+set(RunCMake_TEST_OPTIONS --profiling-format=google-trace)
+run_cmake(profiling-no-output)
+unset(RunCMake_TEST_OPTIONS)
+set(RunCMake_TEST_OPTIONS --profiling-format=json
+  --profiling-output=${RunCMake_BINARY_DIR}/profiling-bad-format-build/p.json)
+run_cmake(profiling-bad-format)
+unset(RunCMake_TEST_OPTIONS)
+
 set(RunCMake_TEST_OPTIONS --debug-trycompile)
 run_cmake(debug-trycompile)
 unset(RunCMake_TEST_OPTIONS)
@@ -0,0 +1,24 @@
+set(output "${RunCMake_TEST_BINARY_DIR}/profile.json")
+if(NOT EXISTS "${output}")
+  set(RunCMake_TEST_FAILED "Profile '${output}' not written.")
+  return()
+endif()
+file(READ "${output}" profile)
+foreach(event
+    "\"cat\":\"cmake.listfile\",\"name\":\"[^\"]*/CMakeLists.txt\""
+    "\"args\":{\"functionArgs\":\"arg\",\"location\":\"[^\"]*/profiling.cmake:4\"},\"cat\":\"cmake\",\"name\":\"profiled_function\""
+    "\"args\":{\"functionArgs\":\"var value\",\"location\":\"[^\"]*/profiling.cmake:2\"},\"cat\":\"cmake\",\"name\":\"set\""
+    "\"ph\":\"E\""
+    "\"cat\":\"cmake.generate\",\"name\":\"Compute\""
+    "\"cat\":\"cmake.generate\",\"name\":\"CheckRuleHashes\""
+    "\"args\":{\"bytes\":[0-9]+,\"replaced\":(true|false)},\"cat\":\"cmake.file\",\"name\":\"[^\"]*/cmake_install.cmake\""
+    "\"cat\":\"cmake.generate\",\"name\":\"generator expression evaluations\""
+    )
+  if(NOT profile MATCHES "${event}")
+    set(RunCMake_TEST_FAILED "Profile does not contain an event matching\n  ${event}\nActual profile:\n${profile}")
+    return()
+  endif()
+endforeach()
+if(NOT profile MATCHES "^\\[.*\\]\n$")
+  set(RunCMake_TEST_FAILED "Profile is not a JSON array:\n${profile}")
+endif()
@@ -0,0 +1,4 @@
+function(profiled_function)
+  set(var value)
+endfunction()
+profiled_function(arg)
@@ -0,0 +1,8 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/compile_commands.json" compile_commands)
+if(compile_commands MATCHES "\"command\":")
+  set(RunCMake_TEST_FAILED "compile_commands.json has a command string")
+elseif(NOT compile_commands MATCHES "\"arguments\": \\[[^\n]*\"[^\"\n]*empty\\.c\"\\]")
+  set(RunCMake_TEST_FAILED "compile_commands.json has no arguments for empty.c")
+elseif(NOT compile_commands MATCHES "\"arguments\": \\[[^\n]*\"-DSTR=\\\\\"a b\\\\\"\"[^\n]*other\\.c\"\\]")
+  set(RunCMake_TEST_FAILED "compile_commands.json has no arguments for other.c")
+endif()
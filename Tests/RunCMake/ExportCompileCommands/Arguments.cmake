@@ -0,0 +1,2 @@
+set(CMAKE_EXPORT_COMPILE_COMMANDS_ARGUMENTS 1)
+include(Command.cmake)
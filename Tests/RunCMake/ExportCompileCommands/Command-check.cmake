@@ -0,0 +1,8 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/compile_commands.json" compile_commands)
+if(NOT compile_commands MATCHES "\"command\": \"[^\n]*empty\\.c\"")
+  set(RunCMake_TEST_FAILED "compile_commands.json has no command for empty.c")
+elseif(NOT compile_commands MATCHES "\"command\": \"[^\n]*STR[^\n]*other\\.c\"")
+  set(RunCMake_TEST_FAILED "compile_commands.json has no command for other.c")
+elseif(compile_commands MATCHES "\"command\": \"[^\n]*STR[^\n]*empty\\.c\"")
+  set(RunCMake_TEST_FAILED "compile_commands.json uses definitions of other.c for empty.c")
+endif()
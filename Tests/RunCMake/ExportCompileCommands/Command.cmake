@@ -0,0 +1,3 @@
+set(CMAKE_EXPORT_COMPILE_COMMANDS 1)
+add_library(empty STATIC empty.c other.c)
+set_property(SOURCE other.c PROPERTY COMPILE_DEFINITIONS [[STR="a b"]])
@@ -0,0 +1,4 @@
+include(RunCMake)
+
+run_cmake(Command)
+run_cmake(Arguments)
@@ -0,0 +1 @@
+int empty(void) { return 0; }
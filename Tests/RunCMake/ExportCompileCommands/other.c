@@ -0,0 +1 @@
+const char* other(void) { return STR; }
@@ -48,6 +48,21 @@ function(run_SubDir)
 endfunction()
 run_SubDir()
 
+function(run_Subninja)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Subninja-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  run_cmake(Subninja)
+  if(WIN32)
+    set(SubDir_all [[SubDir\all]])
+  else()
+    set(SubDir_all [[SubDir/all]])
+  endif()
+  run_cmake_command(Subninja-build ${CMAKE_COMMAND} --build . --target ${SubDir_all})
+endfunction()
+run_Subninja()
+
 function(run_ninja dir)
   execute_process(
     COMMAND "${RunCMake_MAKE_PROGRAM}"
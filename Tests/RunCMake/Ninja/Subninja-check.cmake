@@ -0,0 +1,6 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_ninja)
+if(NOT build_ninja MATCHES "\nsubninja SubDir/CMakeFiles/build.ninja\n")
+  set(RunCMake_TEST_FAILED "build.ninja does not read SubDir/CMakeFiles/build.ninja")
+elseif(build_ninja MATCHES "Building[^\n]*InAll")
+  set(RunCMake_TEST_FAILED "build.ninja contains build statements of SubDir")
+endif()
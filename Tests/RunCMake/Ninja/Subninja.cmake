@@ -0,0 +1,2 @@
+set(CMAKE_NINJA_SUBNINJA_FILES 1)
+add_subdirectory(SubDir)
@@ -40,3 +40,27 @@ function(run_BuildChangeId)
   run_ctest(BuildChangeId)
 endfunction()
 run_BuildChangeId()
+
+function(run_BuildCustomMatch)
+  set(CASE_CMAKELISTS_SUFFIX_CODE [[
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/emit.cmake" "
+message(STATUS \"custom-problem x+y\")
+message(STATUS \"custom-problem xy\")
+message(STATUS \"beta-caution here\")
+message(STATUS \"alpha-caution ignored\")
+")
+add_custom_target(EmitDiagnostics ALL
+  COMMAND ${CMAKE_COMMAND} -P ${CMAKE_CURRENT_BINARY_DIR}/emit.cmake)
+]])
+  set(CASE_TEST_PREFIX_CODE [[
+set(CTEST_CUSTOM_ERROR_MATCH "custom-problem x\\+y")
+set(CTEST_CUSTOM_WARNING_MATCH "(alpha|beta)-caution")
+set(CTEST_CUSTOM_WARNING_EXCEPTION "caution ignored")
+]])
+  set(CASE_TEST_SUFFIX_CODE [[
+message("errors=${num_errors} warnings=${num_warnings}")
+]])
+  run_ctest_build(BuildCustomMatch
+    NUMBER_ERRORS num_errors NUMBER_WARNINGS num_warnings)
+endfunction()
+run_BuildCustomMatch()
@@ -0,0 +1,17 @@
+set(mylist a b)
+list(APPEND mylist "" c)
+list(APPEND mylist "[d;e]" "f\;g")
+list(LENGTH mylist len)
+message("mylist is: ${mylist} (${len})")
+foreach(item ${mylist})
+  message("item: ${item}")
+endforeach()
+
+function(append_in_function)
+  list(APPEND mylist h)
+  list(GET mylist -1 last)
+  message("function: ${last}")
+endfunction()
+append_in_function()
+list(GET mylist -1 last)
+message("after: ${last}")
@@ -8,6 +8,7 @@ run_cmake(EmptyInsert-1)
 run_cmake(NoArguments)
 run_cmake(InvalidSubcommand)
 run_cmake(GET-CMP0007-WARN)
+run_cmake(APPEND-Elements)
 
 run_cmake(FILTER-REGEX-InvalidRegex)
 run_cmake(GET-InvalidIndex)
@@ -0,0 +1,16 @@
+# Subexpressions report their last repetition.
+string(REGEX MATCH "^(([a-z]+)[.]?)+$" output "first.second.third")
+message("MATCH: ${output} ${CMAKE_MATCH_1} ${CMAKE_MATCH_2}")
+
+# Alternatives are tried in order.
+string(REGEX MATCH "(a|ab)(c|bcd)(d*)" output "abcd")
+message("ORDER: ${CMAKE_MATCH_1};${CMAKE_MATCH_2};${CMAKE_MATCH_3}")
+
+string(REGEX REPLACE "([0-9]+)\\.([0-9]+)" "\\2.\\1" output "1.2 3.4")
+message("REPLACE: ${output}")
+
+# Matching time does not grow exponentially with the input.
+string(RANDOM LENGTH 40 ALPHABET a input)
+if(NOT "${input}xc" MATCHES "^(a|aa)*c")
+  message("NO MATCH")
+endif()
@@ -15,6 +15,7 @@ run_cmake(UuidMissingTypeValue)
 run_cmake(UuidBadType)
 
 run_cmake(RegexClear)
+run_cmake(RegexMatch)
 
 run_cmake(UTF-16BE)
 run_cmake(UTF-16LE)
@@ -0,0 +1,67 @@
+enable_language(C)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/include/direct.h
+  "#define DIRECT_VALUE 0\n")
+
+macro(record name)
+  list(APPEND order "${name}=${${name}}")
+  set(out_${name} "${out}")
+endmacro()
+
+#-----------------------------------------------------------------------------
+try_compile(pass ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/direct.c
+  CMAKE_FLAGS -DINCLUDE_DIRECTORIES=${CMAKE_CURRENT_BINARY_DIR}/include
+  COMPILE_DEFINITIONS -DDIRECT_DEF
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  COPY_FILE_ERROR copy_err
+  DEFER CALLBACK record pass
+  )
+try_compile(fail ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/direct.c
+  CMAKE_FLAGS -DINCLUDE_DIRECTORIES=${CMAKE_CURRENT_BINARY_DIR}/include
+  OUTPUT_VARIABLE out
+  DEFER CALLBACK record fail
+  )
+try_compile(plain ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  DEFER
+  )
+if(DEFINED pass OR DEFINED fail OR DEFINED plain OR order)
+  message(FATAL_ERROR "try_compile DEFER ran the checks too early")
+endif()
+
+try_compile_wait()
+if(NOT order STREQUAL "pass=TRUE;fail=FALSE")
+  message(FATAL_ERROR "try_compile DEFER callbacks out of order: ${order}")
+endif()
+if(NOT plain)
+  message(FATAL_ERROR "try_compile DEFER without CALLBACK failed")
+endif()
+if(copy_err OR NOT EXISTS ${CMAKE_CURRENT_BINARY_DIR}/copy)
+  message(FATAL_ERROR "try_compile DEFER COPY_FILE failed:\n${copy_err}")
+endif()
+if(NOT "x${out_fail}" MATCHES "DIRECT_DEF is not defined")
+  message(FATAL_ERROR "try_compile DEFER did not fail with DIRECT_DEF:\n"
+    "${out_fail}")
+endif()
+
+#-----------------------------------------------------------------------------
+# A check that needs a test project runs right away, after those queued
+# before it.
+set(order)
+try_compile(queued ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  DEFER CALLBACK record queued
+  )
+set(CMAKE_POSITION_INDEPENDENT_CODE 1)
+try_compile(project ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  DEFER CALLBACK record project
+  )
+unset(CMAKE_POSITION_INDEPENDENT_CODE)
+if(NOT order STREQUAL "queued=TRUE;project=TRUE")
+  message(FATAL_ERROR "try_compile DEFER fallback out of order: ${order}")
+endif()
@@ -0,0 +1,71 @@
+enable_language(C)
+set(CMAKE_TRY_COMPILE_DIRECT 1)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/include/direct.h
+  "#define DIRECT_VALUE 0\n")
+
+function(check_direct src)
+  if(NOT "x${out}" MATCHES "Run Build Command:[^\n]*${src}")
+    message(FATAL_ERROR "try_compile did not run the compiler directly:\n${out}")
+  endif()
+endfunction()
+
+#-----------------------------------------------------------------------------
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/direct.c
+  CMAKE_FLAGS -DINCLUDE_DIRECTORIES=${CMAKE_CURRENT_BINARY_DIR}/include
+  COMPILE_DEFINITIONS -DDIRECT_DEF
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  COPY_FILE_ERROR copy_err
+  )
+if(NOT result)
+  message(FATAL_ERROR "try_compile failed:\n${out}")
+endif()
+if(copy_err)
+  message(FATAL_ERROR "try_compile COPY_FILE failed:\n${copy_err}")
+endif()
+check_direct("direct\\.c")
+
+#-----------------------------------------------------------------------------
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/direct.c
+  CMAKE_FLAGS -DINCLUDE_DIRECTORIES=${CMAKE_CURRENT_BINARY_DIR}/include
+  OUTPUT_VARIABLE out
+  )
+if(result)
+  message(FATAL_ERROR "try_compile passed but should have failed:\n${out}")
+elseif(NOT "x${out}" MATCHES "DIRECT_DEF is not defined")
+  message(FATAL_ERROR "try_compile did not fail with DIRECT_DEF:\n${out}")
+endif()
+check_direct("direct\\.c")
+
+#-----------------------------------------------------------------------------
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/other.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  COPY_FILE_ERROR copy_err
+  )
+if(NOT result)
+  message(FATAL_ERROR "try_compile failed:\n${out}")
+endif()
+if(copy_err)
+  message(FATAL_ERROR "try_compile COPY_FILE failed:\n${copy_err}")
+endif()
+check_direct("other\\.c")
+unset(CMAKE_TRY_COMPILE_TARGET_TYPE)
+
+#-----------------------------------------------------------------------------
+# Variables forwarded to the test project need the full test project.
+set(CMAKE_POSITION_INDEPENDENT_CODE 1)
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  )
+if(NOT result)
+  message(FATAL_ERROR "try_compile failed:\n${out}")
+endif()
+if("x${out}" MATCHES "Run Build Command:[^\n]*src\\.c")
+  message(FATAL_ERROR "try_compile did not use a test project:\n${out}")
+endif()
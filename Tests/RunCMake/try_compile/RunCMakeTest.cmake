@@ -15,6 +15,7 @@ run_cmake(BadSources1)
 run_cmake(BadSources2)
 run_cmake(NonSourceCopyFile)
 run_cmake(NonSourceCompileDefinitions)
+run_cmake(CallbackNoDefer)
 
 set(RunCMake_TEST_OPTIONS --debug-trycompile)
 run_cmake(PlatformVariables)
@@ -27,6 +28,11 @@ run_cmake(TargetTypeStatic)
 run_cmake(CMP0056)
 run_cmake(CompileFlags)
 
+if(RunCMake_GENERATOR MATCHES "Unix Makefiles|Ninja" AND NOT CMAKE_HOST_WIN32)
+  run_cmake(Direct)
+  run_cmake(Defer)
+endif()
+
 if(RunCMake_GENERATOR MATCHES "Make|Ninja")
   # Use a single build tree for a few tests without cleaning.
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/RerunCMake-build)
@@ -0,0 +1,8 @@
+#include "direct.h"
+#ifndef DIRECT_DEF
+#error DIRECT_DEF is not defined
+#endif
+int main(void)
+{
+  return DIRECT_VALUE;
+}
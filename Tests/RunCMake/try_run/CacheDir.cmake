@@ -0,0 +1,48 @@
+set(CMAKE_TRY_COMPILE_CACHE_DIR ${CMAKE_CURRENT_BINARY_DIR}/cache)
+file(REMOVE_RECURSE ${CMAKE_TRY_COMPILE_CACHE_DIR})
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/args.c [[
+#include <stdio.h>
+int main(int argc, char* argv[])
+{
+  printf("arg %s\n", argc > 1 ? argv[1] : "none");
+  return 3;
+}
+]])
+
+macro(check_run arg cached)
+  try_run(run_result compile_result ${CMAKE_CURRENT_BINARY_DIR}
+    ${CMAKE_CURRENT_BINARY_DIR}/args.c
+    COMPILE_OUTPUT_VARIABLE compile_out
+    RUN_OUTPUT_VARIABLE run_out
+    ARGS ${arg}
+    )
+  if(NOT compile_result OR NOT run_result EQUAL 3 OR
+      NOT run_out STREQUAL "arg ${arg}\n")
+    message(FATAL_ERROR "try_run ${arg} failed: ${run_result} [${run_out}]\n"
+      "${compile_out}")
+  endif()
+  if(${cached} AND NOT compile_out MATCHES "^Using cached result")
+    message(FATAL_ERROR "try_run ${arg} did not use the cache:\n"
+      "${compile_out}")
+  elseif(NOT ${cached} AND compile_out MATCHES "^Using cached result")
+    message(FATAL_ERROR "try_run ${arg} used the cache:\n${compile_out}")
+  endif()
+endmacro()
+
+check_run(first 0)
+check_run(first 1)
+check_run(second 0)
+
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/args.c "does-not-compile\n")
+foreach(cached 0 1)
+  try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+    ${CMAKE_CURRENT_BINARY_DIR}/args.c
+    OUTPUT_VARIABLE out
+    )
+  if(result)
+    message(FATAL_ERROR "try_compile passed but should have failed:\n${out}")
+  endif()
+  if(cached AND NOT out MATCHES "^Using cached result")
+    message(FATAL_ERROR "try_compile did not use the cache:\n${out}")
+  endif()
+endforeach()
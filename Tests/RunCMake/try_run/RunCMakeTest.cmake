@@ -1,3 +1,4 @@
 include(RunCMake)
 
 run_cmake(BadLinkLibraries)
+run_cmake(CacheDir)